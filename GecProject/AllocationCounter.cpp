@@ -0,0 +1,79 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef GEC_COUNT_ALLOCATIONS
+
+namespace
+{
+	std::atomic<std::uint64_t> g_allocationCount{ 0 };
+
+	void* allocate(std::size_t size)
+	{
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	// Over-aligned types need the platform's aligned allocation, which has its own matching free
+	void* allocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+		return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+		return std::aligned_alloc(align, (size + align - 1) / align * align); // The size has to be a multiple of the alignment
+#endif
+	}
+
+	void freeAligned(void* pointer)
+	{
+#ifdef _WIN32
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+}
+
+std::uint64_t AllocationCounter::getCount() { return g_allocationCount.load(std::memory_order_relaxed); }
+
+// Every replaceable form of the global operators, so nothing slips past the count or is freed by the wrong function
+void* operator new(std::size_t size)
+{
+	if (void* pointer = allocate(size)) return pointer;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* pointer = allocateAligned(size, alignment)) return pointer;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(pointer); }
+
+#else
+
+std::uint64_t AllocationCounter::getCount() { return 0; }
+
+#endif
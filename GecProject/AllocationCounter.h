@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+
+// Opt-in count of heap allocations, for catching allocations in code that should run without any
+// Building with GEC_COUNT_ALLOCATIONS defined replaces the global operator new, so every allocation on every thread is counted
+// Without it nothing is replaced and the count always reads zero
+namespace AllocationCounter
+{
+#ifdef GEC_COUNT_ALLOCATIONS
+	constexpr bool Enabled = true;
+#else
+	constexpr bool Enabled = false;
+#endif
+
+	std::uint64_t getCount(); // Allocations made since the program started
+}
+
+// Counts the allocations made, on any thread, while it is in scope
+class AllocationScope
+{
+public:
+	AllocationScope() : m_start(AllocationCounter::getCount()) {}
+
+	std::uint64_t getCount() const { return AllocationCounter::getCount() - m_start; }
+private:
+	std::uint64_t m_start;
+};
@@ -0,0 +1,78 @@
+#include "AllocationTest.h"
+#include "AllocationCounter.h"
+#include "JobSystem.h"
+#include "TextureManager.h"
+#include "Simulation.h"
+#include <iostream>
+
+int AllocationTest::run(int warmupTicks, int measuredTicks)
+{
+	if (!AllocationCounter::Enabled)
+	{
+		std::cout << "Allocation test needs a build with GEC_COUNT_ALLOCATIONS defined" << std::endl;
+		return 2;
+	}
+
+	JobSystem jobSystem;
+	TextureManager textureManager(jobSystem);
+	Simulation simulation(textureManager, jobSystem);
+
+	// Nobody is watching, so everything in the level is simulated rather than just what's near a camera
+	simulation.setActivationEnabled(false);
+
+	InputManager& input = simulation.getInputManager();
+	input.setKeyboardEnabled(false);
+
+	constexpr float DeltaTime = 1.f / 60.f;
+	constexpr int ReportLimit = 10; // Only the first few allocating ticks are printed
+
+	int measureFrom = warmupTicks; // Pushed back whenever the level is reloaded, as loading is allowed to allocate
+	int measured = 0;
+	int allocatingTicks = 0;
+	std::uint64_t allocations = 0;
+
+	for (int tick = 0; measured < measuredTicks; ++tick)
+	{
+		// Paces back and forth near the start, jumping and shooting on a fixed rhythm, so enemies see the player and fire back
+		bool facingRight = (tick / 240) % 2 == 0;
+		input.simulateAction(facingRight ? Actions::eMoveRight : Actions::eMoveLeft);
+		if (tick % 45 == 0)
+			input.simulateAction(Actions::eJump);
+		if (tick % 20 == 0)
+			input.simulateAction(Actions::eShoot);
+
+		AllocationScope scope;
+		simulation.update(DeltaTime);
+		std::uint64_t count = scope.getCount();
+
+		if (tick >= measureFrom)
+		{
+			measured++;
+
+			if (count > 0)
+			{
+				if (allocatingTicks < ReportLimit)
+					std::cout << "  Tick " << tick << " made " << count << " allocations" << std::endl;
+
+				allocatingTicks++;
+				allocations += count;
+			}
+		}
+
+		if (simulation.isGameOver() || simulation.isLevelComplete())
+		{
+			simulation.reset();
+			measureFrom = tick + 1 + warmupTicks;
+		}
+	}
+
+	std::cout << "Allocation test, " << measured << " ticks after a " << warmupTicks << " tick warm up: ";
+	if (allocatingTicks == 0)
+	{
+		std::cout << "no allocations" << std::endl;
+		return 0;
+	}
+
+	std::cout << allocatingTicks << " ticks allocated, " << allocations << " allocations in all" << std::endl;
+	return 1;
+}
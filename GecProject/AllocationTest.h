@@ -0,0 +1,9 @@
+#pragma once
+
+// Plays the first level headlessly with scripted input, checking that the simulation stops allocating once it has warmed up
+// Run with --alloc-test, needs a build with GEC_COUNT_ALLOCATIONS defined
+namespace AllocationTest
+{
+	// Returns the exit code - 0 if no measured tick allocated, 1 if any did, 2 if the counter isn't compiled in
+	int run(int warmupTicks = 300, int measuredTicks = 1800);
+}
@@ -28,6 +28,19 @@ class AnimationManager
 public:
 	AnimationManager(TextureManager& texureManager) : m_textureManager(texureManager)
 	{
+		// Decodes every sprite sheet at once, so the configure calls below only look the loaded textures up
+		m_textureManager.preloadTextures({
+			"Data/Textures/Player/skeleton_idle.png",
+			"Data/Textures/Player/skeleton_jump.png",
+			"Data/Textures/Player/skeleton_jumpShot.png",
+			"Data/Textures/Player/skeleton_standingShot.png",
+			"Data/Textures/Player/skeleton_walk.png",
+			"Data/Textures/Player/skeleton_walkShot.png",
+			"Data/Textures/World/coin.png",
+			"Data/Textures/bullet.png",
+			"Data/Textures/World/tilemap_packed.png",
+			"Data/Textures/World/door.png" });
+
 		// Loading the sprite sheets
 		// Animations
 		// Player / Enemy - Enemy will be changed later
@@ -81,6 +94,9 @@ public:
 			configureStaticSprite(tileName, "Data/Textures/World/tilemap_packed.png", sf::IntRect({ x, y }, { tileWidth, tileHeight }));
 		}
 
+		// Moving platform - the three tile floating platform as one sprite
+		configureStaticSprite("platform", "Data/Textures/World/tilemap_packed.png", sf::IntRect({ 18, 0 }, { 54, 18 }));
+
 		// Door
 		configureStaticSprite("door", "Data/Textures/World/door.png", sf::IntRect({ 0, 0 }, { 21, 28 }));
 	}
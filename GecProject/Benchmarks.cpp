@@ -0,0 +1,244 @@
+#include "Benchmarks.h"
+#include "PhysicsStore.h"
+#include "Bullet.h"
+#include "PackedRectangles.h"
+#include "TileLayer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const int Iterations = 100; // Each benchmark is repeated and averaged, to smooth out noise
+	const float DeltaTime = 1.f / 60.f;
+	const float Gravity = 980.f;
+
+	using Clock = std::chrono::steady_clock;
+
+	// Average nanoseconds per item for a function run over the given item count
+	template <typename Function>
+	double nanosecondsPerItem(int itemCount, Function&& function)
+	{
+		function(); // Warms the caches up first
+
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < Iterations; ++i)
+			function();
+		Clock::time_point end = Clock::now();
+
+		double total = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		return total / (static_cast<double>(Iterations) * itemCount);
+	}
+
+	// Mirrors how the physics state used to be stored - inside each heap allocated entity, alongside its sprite
+	struct ObjectBody
+	{
+		sf::Sprite sprite;
+		sf::Vector2f velocity;
+		CollisionRectangle hitbox;
+		bool grounded{ false };
+
+		explicit ObjectBody(const sf::Texture& texture) : sprite(texture) {}
+	};
+}
+
+void Benchmarks::runAll()
+{
+	std::cout << "Running benchmarks..." << std::endl;
+
+	runPhysicsStore();
+	runRectangleKernel();
+	runTileRaycast();
+}
+
+// Integrating and syncing bodies through the PhysicsStore, against the same work on separately allocated entities
+void Benchmarks::runPhysicsStore(int bodyCount)
+{
+	sf::Texture texture; // Never drawn, the entities only need something to point at
+	StaticSprite sprite{ &texture, sf::IntRect({ 0, 0 }, { 8, 8 }) };
+
+	std::mt19937 random(1234); // Fixed seed, so every run tests the same bodies
+	std::uniform_real_distribution<float> position(0.f, 4000.f);
+	std::uniform_real_distribution<float> velocity(-100.f, 100.f);
+
+	// Separately allocated bodies, shuffled so they are visited out of allocation order like entities in a long running level
+	std::vector<std::unique_ptr<ObjectBody>> objects;
+	for (int i = 0; i < bodyCount; ++i)
+	{
+		auto object = std::make_unique<ObjectBody>(texture);
+		object->sprite.setPosition({ position(random), position(random) });
+		object->velocity = { velocity(random), velocity(random) };
+		object->hitbox.m_width = 8.f;
+		object->hitbox.m_height = 8.f;
+		objects.push_back(std::move(object));
+	}
+	std::shuffle(objects.begin(), objects.end(), random);
+
+	double objectTime = nanosecondsPerItem(bodyCount, [&]()
+		{
+			for (auto& object : objects)
+			{
+				object->velocity.y += Gravity * DeltaTime;
+				object->sprite.move(object->velocity * DeltaTime);
+
+				sf::Vector2f pos = object->sprite.getPosition();
+				object->hitbox.m_xPos = pos.x - object->hitbox.m_width / 2.f;
+				object->hitbox.m_yPos = pos.y - object->hitbox.m_height / 2.f;
+			}
+		});
+
+	// The same bodies in the store
+	PhysicsStore store;
+	std::vector<std::unique_ptr<Bullet>> bullets;
+	bullets.reserve(bodyCount);
+
+	for (int i = 0; i < bodyCount; ++i)
+	{
+		bullets.push_back(std::make_unique<Bullet>(store, sprite));
+		bullets.back()->setPosition({ position(random), position(random) });
+		bullets.back()->setVelocity({ velocity(random), velocity(random) });
+		bullets.back()->setGravity(Gravity); // Bullets have none, but the comparison needs the same work
+	}
+
+	int bodies = static_cast<int>(store.size());
+	std::vector<CollisionRectangle> hitboxes(bodies);
+
+	double storeTime = nanosecondsPerItem(bodyCount, [&]()
+		{
+			store.integrate(DeltaTime);
+
+			for (int i = 0; i < bodies; ++i)
+				hitboxes[i] = store.getHitbox(i);
+		});
+
+	double scatterTime = nanosecondsPerItem(bodyCount, [&]() { store.scatter(); });
+
+	std::cout << "Physics store, " << bodyCount << " bodies:" << std::endl;
+	std::cout << "  Separate entities: " << objectTime << " ns/body" << std::endl;
+	std::cout << "  Physics store: " << storeTime << " ns/body (+ " << scatterTime << " ns/body writing back to the entities)" << std::endl;
+}
+
+// One rectangle against many - pair by pair with CollisionRectangle::intersection, against PackedRectangles' scalar and SIMD paths
+void Benchmarks::runRectangleKernel(int rectangleCount)
+{
+	const int queryCount = 64;
+
+	std::mt19937 random(1234); // Fixed seed, so every run tests the same rectangles
+	std::uniform_real_distribution<float> position(0.f, 4000.f);
+	std::uniform_real_distribution<float> size(4.f, 64.f);
+
+	std::vector<CollisionRectangle> rectangles;
+	PackedRectangles packed;
+	for (int i = 0; i < rectangleCount; ++i)
+	{
+		CollisionRectangle rect(position(random), position(random), size(random), size(random));
+		rectangles.push_back(rect);
+		packed.add(rect);
+	}
+
+	std::vector<CollisionRectangle> queries;
+	for (int i = 0; i < queryCount; ++i)
+		queries.emplace_back(position(random), position(random), size(random) * 4.f, size(random) * 4.f);
+
+	std::vector<int> hits;
+	hits.reserve(rectangleCount);
+	// Hits are summed so each path's work can't be optimised away, and printed so they can be checked to agree
+	std::size_t pairHits = 0;
+	std::size_t scalarHits = 0;
+	std::size_t simdHits = 0;
+
+	int pairCount = rectangleCount * queryCount;
+
+	double pairTime = nanosecondsPerItem(pairCount, [&]()
+		{
+			for (const CollisionRectangle& query : queries)
+			{
+				hits.clear();
+				for (int i = 0; i < rectangleCount; ++i)
+				{
+					if (query.intersection(rectangles[i]))
+						hits.push_back(i);
+				}
+				pairHits += hits.size();
+			}
+		});
+
+	double scalarTime = nanosecondsPerItem(pairCount, [&]()
+		{
+			for (const CollisionRectangle& query : queries)
+			{
+				hits.clear();
+				scalarHits += packed.intersectAllScalar(query, hits);
+			}
+		});
+
+	double simdTime = nanosecondsPerItem(pairCount, [&]()
+		{
+			for (const CollisionRectangle& query : queries)
+			{
+				hits.clear();
+				simdHits += packed.intersectAll(query, hits);
+			}
+		});
+
+	const int runs = Iterations + 1; // Including the warm up
+
+	std::cout << "Rectangle kernel, " << queryCount << " queries against " << rectangleCount << " rectangles:" << std::endl;
+	std::cout << "  CollisionRectangle::intersection: " << pairTime << " ns/pair (" << pairHits / runs << " hits)" << std::endl;
+	std::cout << "  Packed scalar: " << scalarTime << " ns/pair (" << scalarHits / runs << " hits)" << std::endl;
+	std::cout << "  Packed " << PackedRectangles::getKernelName() << ": " << simdTime << " ns/pair (" << simdHits / runs << " hits)" << std::endl;
+}
+
+// Line of sight rays through a randomly filled tile grid, in rays per millisecond
+void Benchmarks::runTileRaycast(int rayCount)
+{
+	const int columns = 400;
+	const int rows = 60;
+	const float tileSize = 18.f;
+	const float rayLength = 200.f; // About an enemy's vision range
+
+	std::mt19937 random(1234); // Fixed seed, so every run casts the same rays
+	std::uniform_int_distribution<int> chance(0, 9);
+
+	// Roughly one tile in ten is solid, similar to the open parts of a level
+	TileLayer tiles;
+	tiles.resize(columns, rows, tileSize);
+	for (int row = 0; row < rows; ++row)
+	{
+		for (int column = 0; column < columns; ++column)
+		{
+			if (chance(random) == 0)
+				tiles.setTile(column, row, 1);
+		}
+	}
+
+	std::uniform_real_distribution<float> positionX(0.f, columns * tileSize);
+	std::uniform_real_distribution<float> positionY(0.f, rows * tileSize);
+	std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+
+	std::vector<float> rays; // Start and end of each ray, four floats per ray
+	rays.reserve(static_cast<std::size_t>(rayCount) * 4);
+	for (int i = 0; i < rayCount; ++i)
+	{
+		float startX = positionX(random);
+		float startY = positionY(random);
+		float direction = angle(random);
+
+		rays.insert(rays.end(), { startX, startY, startX + std::cos(direction) * rayLength, startY + std::sin(direction) * rayLength });
+	}
+
+	int hitCount = 0;
+	double rayTime = nanosecondsPerItem(rayCount, [&]()
+		{
+			TileRaycastHit hit;
+			for (std::size_t i = 0; i < rays.size(); i += 4)
+				hitCount += tiles.raycast(rays[i], rays[i + 1], rays[i + 2], rays[i + 3], hit) ? 1 : 0;
+		});
+
+	std::cout << "Tile raycast, " << rayCount << " rays of " << rayLength << "px (" << hitCount / (Iterations + 1) << " hits):" << std::endl;
+	std::cout << "  " << 1000000.0 / rayTime << " rays/ms (" << rayTime << " ns/ray)" << std::endl;
+}
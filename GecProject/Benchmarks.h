@@ -0,0 +1,17 @@
+#pragma once
+
+// Microbenchmarks for the engine's hot paths, run on demand from the GUI with the results printed to the console
+// They run on synthetic data, so can be compared between builds without loading a level
+namespace Benchmarks
+{
+	void runAll(); // Runs every benchmark below
+
+	// Integrating and syncing bodies through the PhysicsStore, against the same work on separately allocated entities
+	void runPhysicsStore(int bodyCount = 10000);
+
+	// One rectangle against many - pair by pair with CollisionRectangle::intersection, against PackedRectangles' scalar and SIMD paths
+	void runRectangleKernel(int rectangleCount = 4096);
+
+	// Line of sight rays through a randomly filled tile grid, in rays per millisecond
+	void runTileRaycast(int rayCount = 100000);
+}
@@ -4,47 +4,37 @@
 class Bullet : public DynamicEntity
 {
 public:
-    Bullet(const StaticSprite& sprite)
-        : DynamicEntity(sprite, EntityType::Bullet)
+    Bullet(PhysicsStore& store, const StaticSprite& sprite)
+        : DynamicEntity(store, sprite, EntityType::Bullet)
     {
-        m_gravity = 0.f; // Disables gravity for the the bullet
+        this->setGravity(0.f); // Disables gravity for the the bullet
+        m_store->setFlag(m_bodyIndex, BodyFlags::Continuous, true); // Bullets are swept by the simulation, not resolved per axis
     }
 
-    // Sets the bullet up when its been fired - activated
-    void fire(sf::Vector2f position, sf::Vector2f velocity, bool isEnemy = false)
+    // Sets the bullet up when its been fired - activated, who it can hit is set by the simulation through its collision layer
+    void fire(sf::Vector2f position, sf::Vector2f velocity)
     {
         m_active = true;
         this->setPosition(position);
 		this->setPreviousPosition(position); // For interpolation - fixes the bullet appearing to jump on respawn
-        m_velocity = velocity;
-        m_lifetime = 3.f;    // Reset the timer
+        this->setVelocity(velocity);
         this->syncHitbox();  // Ensure hitbox is at the new position immediately
-		m_isEnemyBullet = isEnemy; // Used to differentiate between player and enemy bullets, for collisions
     }
 
-	bool isEnemyBullet() const { return m_isEnemyBullet; } // Checks if the bullet was fired by an enemy
-
 	// Used to deactivate the bullet when its lifetime is over or it hits something
     void deactivate()
     {
         m_active = false;
+        this->setVelocity({ 0.f, 0.f }); // Still integrated with every other body while pooled, so is stopped where it is
     }
 
 	bool isActive() const { return m_active; } // Checks if the bullet is currently active
 
-	// Deactivates the bullet after its lifetime is over
-    void update(float deltaTime) override
-    {
-        m_lifetime -= deltaTime;
-        if (m_lifetime <= 0.f)
-        {
-			deactivate();
-        }
+	// The timer that deactivates the bullet once its lifetime is over, scheduled by the simulation when it fires the bullet
+	TimerHandle& getLifetimeTimer() { return m_lifetimeTimer; }
 
-        DynamicEntity::update(deltaTime); // Calls the base class update to handle animation and movement
-    }
+    static constexpr float Lifetime = 3.f; // How long the bullet lasts before being deactivated, in seconds
 private:
-    float m_lifetime{ 1.f }; // How long the bullet will last before being deactivated
+    TimerHandle m_lifetimeTimer;
     bool m_active{ false };
-    bool m_isEnemyBullet{ false }; // Used to differentiate between player and enemy bullets, for collisions
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// The collision layer bits - every collider belongs to exactly one layer, and carries a mask of the layers it tests against
+namespace CollisionLayers
+{
+	constexpr std::uint32_t None = 0;
+	constexpr std::uint32_t World = 1u << 0; // Solid level tiles
+	constexpr std::uint32_t Player = 1u << 1;
+	constexpr std::uint32_t Enemy = 1u << 2;
+	constexpr std::uint32_t PlayerBullet = 1u << 3;
+	constexpr std::uint32_t EnemyBullet = 1u << 4;
+	constexpr std::uint32_t Collectable = 1u << 5;
+	constexpr std::uint32_t Door = 1u << 6;
+	constexpr std::uint32_t Platform = 1u << 7; // Moving platforms, solid like the world but kept in the body tree
+
+	constexpr int Count = 8; // How many layers there are
+	constexpr std::uint32_t All = (1u << Count) - 1;
+
+	constexpr int indexOf(std::uint32_t layer) { return std::countr_zero(layer); } // Converts a layer bit into 0 - Count
+}
+
+// The per-layer filter matrix, configured once by the simulation. Each row is the mask of layers that layer tests against,
+// rows don't have to be symmetric (e.g. the player is blocked by enemies, but enemies walk through the player)
+class CollisionFilter
+{
+public:
+	// Sets whether colliders on one layer test against colliders on another
+	void setTestsAgainst(std::uint32_t layer, std::uint32_t otherLayers, bool enabled = true)
+	{
+		std::uint32_t& mask = m_masks[CollisionLayers::indexOf(layer)];
+		if (enabled)
+			mask |= otherLayers;
+		else
+			mask &= ~otherLayers;
+	}
+
+	std::uint32_t getMask(std::uint32_t layer) const { return layer == CollisionLayers::None ? CollisionLayers::None : m_masks[CollisionLayers::indexOf(layer)]; }
+private:
+	std::array<std::uint32_t, CollisionLayers::Count> m_masks{};
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <limits>
 
 // Used to represent an entities hitbox - for collisions
 class CollisionRectangle
@@ -23,4 +25,49 @@ public:
 			return false;
 		return true;
 	}
+
+	// Swept test of this rectangle moving by (xMove, yMove) against a stationary rectangle, so fast movers can't tunnel through thin ones
+	// Returns true if the rectangles weren't overlapping at the start but touch during the move, setting timeOfImpact to the
+	// fraction (0 - 1) of the move at which they first touch. Overlapping at the start is left to intersection()
+	bool sweep(float xMove, float yMove, const CollisionRectangle& other, float& timeOfImpact) const
+	{
+		if (xMove == 0.f && yMove == 0.f) return false; // Not moving, so can't enter anything
+
+		float entry = -std::numeric_limits<float>::infinity(); // Latest time the rectangles start overlapping on an axis
+		float exit = std::numeric_limits<float>::infinity(); // Earliest time they stop overlapping on an axis
+
+		// Narrows the entry and exit times for a single axis, returns false if they can never overlap on it
+		auto sweepAxis = [&](float start, float size, float otherStart, float otherSize, float move)
+			{
+				if (move == 0.f)
+					return !(start + size < otherStart || start > otherStart + otherSize); // Must already overlap on this axis
+
+				float axisEntry = (move > 0.f) ? (otherStart - (start + size)) / move : (otherStart + otherSize - start) / move;
+				float axisExit = (move > 0.f) ? (otherStart + otherSize - start) / move : (otherStart - (start + size)) / move;
+
+				entry = std::max(entry, axisEntry);
+				exit = std::min(exit, axisExit);
+				return true;
+			};
+
+		if (!sweepAxis(this->m_xPos, this->m_width, other.m_xPos, other.m_width, xMove)) return false;
+		if (!sweepAxis(this->m_yPos, this->m_height, other.m_yPos, other.m_height, yMove)) return false;
+
+		// A negative entry means they were already overlapping, beyond 1 means they don't touch until after this move
+		if (entry < 0.f || entry > 1.f || entry > exit) return false;
+
+		timeOfImpact = entry;
+		return true;
+	}
+
+	// Returns the smallest rectangle containing both this rectangle and the other - e.g. the area swept by a move
+	CollisionRectangle merge(const CollisionRectangle& other) const
+	{
+		float left = std::min(this->m_xPos, other.m_xPos);
+		float top = std::min(this->m_yPos, other.m_yPos);
+		float right = std::max(this->m_xPos + this->m_width, other.m_xPos + other.m_width);
+		float bottom = std::max(this->m_yPos + this->m_height, other.m_yPos + other.m_height);
+
+		return CollisionRectangle(left, top, bottom - top, right - left);
+	}
 };
\ No newline at end of file
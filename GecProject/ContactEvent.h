@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+class Entity;
+
+// What kind of contact happened, decides which gameplay rule handles it
+enum class ContactKind : std::uint8_t
+{
+	PlayerCollectable, // a is the player, b the collectable
+	PlayerDoor, // a is the player, b the door
+	BulletHitPlayer, // a is the bullet, b the player
+	BulletHitEnemy, // a is the bullet, b the enemy
+	PlayerHazard, // a is the player, b is null as hazards are tiles
+
+	Count
+};
+
+// A contact found by the collision phase, recorded so the gameplay phase can handle every contact of a kind together
+struct ContactEvent
+{
+	Entity* a{ nullptr };
+	Entity* b{ nullptr };
+	ContactKind kind{ ContactKind::PlayerCollectable };
+};
@@ -0,0 +1,342 @@
+#include "DynamicAabbTree.h"
+#include <algorithm>
+#include <cmath>
+
+// Removes every proxy
+void DynamicAabbTree::clear()
+{
+	m_nodes.clear();
+	m_root = NullNode;
+	m_freeList = NullNode;
+	m_proxyCount = 0;
+}
+
+void DynamicAabbTree::reserve(int proxyCount)
+{
+	m_nodes.reserve(static_cast<std::size_t>(proxyCount) * 2); // Every leaf but the first brings a branch with it
+}
+
+// Adds a leaf for the entity, returns its proxy ID
+int DynamicAabbTree::createProxy(const CollisionRectangle& hitbox, Entity* entity, std::uint32_t layer)
+{
+	int proxyId = allocateNode();
+	Node& node = m_nodes[proxyId];
+
+	// Grows the hitbox by the margin, so the leaf survives small moves untouched
+	node.box = CollisionRectangle(hitbox.m_xPos - m_fatMargin, hitbox.m_yPos - m_fatMargin, hitbox.m_height + 2.f * m_fatMargin, hitbox.m_width + 2.f * m_fatMargin);
+	node.entity = entity;
+	node.layers = layer;
+	node.height = 0;
+
+	insertLeaf(proxyId);
+	m_proxyCount++;
+
+	return proxyId;
+}
+
+void DynamicAabbTree::destroyProxy(int proxyId)
+{
+	assert(m_nodes[proxyId].isLeaf());
+
+	removeLeaf(proxyId);
+	freeNode(proxyId);
+	m_proxyCount--;
+}
+
+// Updates a proxy after its entity has moved. Only reinserts it if the hitbox left the fat box, returning whether it did
+bool DynamicAabbTree::moveProxy(int proxyId, const CollisionRectangle& hitbox, sf::Vector2f displacement)
+{
+	Node& node = m_nodes[proxyId];
+
+	if (contains(node.box, hitbox))
+		return false; // Still inside the fat box, the tree doesn't need to change
+
+	removeLeaf(proxyId);
+
+	// Grows the new fat box by the margin, and further in the direction of travel to predict the next few moves
+	CollisionRectangle fatBox(hitbox.m_xPos - m_fatMargin, hitbox.m_yPos - m_fatMargin, hitbox.m_height + 2.f * m_fatMargin, hitbox.m_width + 2.f * m_fatMargin);
+
+	const float predictionMultiplier = 2.f;
+	sf::Vector2f prediction = displacement * predictionMultiplier;
+
+	if (prediction.x < 0.f)
+		fatBox.m_xPos += prediction.x;
+	fatBox.m_width += std::abs(prediction.x);
+
+	if (prediction.y < 0.f)
+		fatBox.m_yPos += prediction.y;
+	fatBox.m_height += std::abs(prediction.y);
+
+	m_nodes[proxyId].box = fatBox;
+	insertLeaf(proxyId);
+
+	return true;
+}
+
+int DynamicAabbTree::allocateNode()
+{
+	// Reuses a free node if there is one
+	if (m_freeList != NullNode)
+	{
+		int nodeId = m_freeList;
+		m_freeList = m_nodes[nodeId].parent;
+		m_nodes[nodeId] = Node{};
+		return nodeId;
+	}
+
+	m_nodes.emplace_back();
+	return static_cast<int>(m_nodes.size()) - 1;
+}
+
+void DynamicAabbTree::freeNode(int nodeId)
+{
+	m_nodes[nodeId] = Node{};
+	m_nodes[nodeId].parent = m_freeList;
+	m_freeList = nodeId;
+}
+
+void DynamicAabbTree::insertLeaf(int leaf)
+{
+	if (m_root == NullNode)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = NullNode;
+		return;
+	}
+
+	// Finds the best sibling, descending towards whichever child grows the tree's total perimeter the least
+	CollisionRectangle leafBox = m_nodes[leaf].box;
+	int index = m_root;
+
+	while (!m_nodes[index].isLeaf())
+	{
+		int child1 = m_nodes[index].child1;
+		int child2 = m_nodes[index].child2;
+
+		float area = perimeter(m_nodes[index].box);
+		float combinedArea = perimeter(m_nodes[index].box.merge(leafBox));
+
+		float cost = 2.f * combinedArea; // Cost of making a new parent for this node and the leaf
+		float inheritanceCost = 2.f * (combinedArea - area); // Minimum cost of pushing the leaf further down
+
+		// Cost of descending into each child
+		auto descendCost = [&](int child)
+			{
+				float merged = perimeter(m_nodes[child].box.merge(leafBox));
+				if (m_nodes[child].isLeaf())
+					return merged + inheritanceCost;
+
+				return (merged - perimeter(m_nodes[child].box)) + inheritanceCost;
+			};
+
+		float cost1 = descendCost(child1);
+		float cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2)
+			break; // Cheapest to pair with this node
+
+		index = (cost1 < cost2) ? child1 : child2;
+	}
+
+	int sibling = index;
+
+	// Creates a new parent for the sibling and the leaf
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = allocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].box = leafBox.merge(m_nodes[sibling].box);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].layers = m_nodes[sibling].layers | m_nodes[leaf].layers;
+	m_nodes[newParent].child1 = sibling;
+	m_nodes[newParent].child2 = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent != NullNode)
+	{
+		if (m_nodes[oldParent].child1 == sibling)
+			m_nodes[oldParent].child1 = newParent;
+		else
+			m_nodes[oldParent].child2 = newParent;
+	}
+	else
+		m_root = newParent; // The sibling was the root
+
+	// Walks back up, fixing heights, boxes and layers and rebalancing along the way
+	index = m_nodes[leaf].parent;
+	while (index != NullNode)
+	{
+		index = balance(index);
+		refit(index);
+
+		index = m_nodes[index].parent;
+	}
+}
+
+void DynamicAabbTree::removeLeaf(int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = NullNode;
+		return;
+	}
+
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	if (grandParent != NullNode)
+	{
+		// Destroys the parent and connects the sibling to the grandparent
+		if (m_nodes[grandParent].child1 == parent)
+			m_nodes[grandParent].child1 = sibling;
+		else
+			m_nodes[grandParent].child2 = sibling;
+
+		m_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		// Adjusts the ancestors' boxes, heights and layers
+		int index = grandParent;
+		while (index != NullNode)
+		{
+			index = balance(index);
+			refit(index);
+
+			index = m_nodes[index].parent;
+		}
+	}
+	else
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = NullNode;
+		freeNode(parent);
+	}
+}
+
+// Performs a left or right rotation if node A is unbalanced, returns the node now in its place
+int DynamicAabbTree::balance(int iA)
+{
+	Node& A = m_nodes[iA];
+	if (A.isLeaf() || A.height < 2)
+		return iA;
+
+	int iB = A.child1;
+	int iC = A.child2;
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+
+	int balanceFactor = C.height - B.height;
+
+	// Rotates C up
+	if (balanceFactor > 1)
+	{
+		int iF = C.child1;
+		int iG = C.child2;
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		// Swaps A and C
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		// A's old parent should point to C
+		if (C.parent != NullNode)
+		{
+			if (m_nodes[C.parent].child1 == iA)
+				m_nodes[C.parent].child1 = iC;
+			else
+				m_nodes[C.parent].child2 = iC;
+		}
+		else
+			m_root = iC;
+
+		// Keeps the taller of F and G under C
+		if (F.height > G.height)
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+		}
+
+		// A is now below C, so is refitted first
+		refit(iA);
+		refit(iC);
+
+		return iC;
+	}
+
+	// Rotates B up
+	if (balanceFactor < -1)
+	{
+		int iD = B.child1;
+		int iE = B.child2;
+		Node& D = m_nodes[iD];
+		Node& E = m_nodes[iE];
+
+		// Swaps A and B
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		// A's old parent should point to B
+		if (B.parent != NullNode)
+		{
+			if (m_nodes[B.parent].child1 == iA)
+				m_nodes[B.parent].child1 = iB;
+			else
+				m_nodes[B.parent].child2 = iB;
+		}
+		else
+			m_root = iB;
+
+		// Keeps the taller of D and E under B
+		if (D.height > E.height)
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+		}
+
+		// A is now below B, so is refitted first
+		refit(iA);
+		refit(iB);
+
+		return iB;
+	}
+
+	return iA;
+}
+
+// Recalculates a branch's box, height and layers from its children
+void DynamicAabbTree::refit(int nodeId)
+{
+	Node& node = m_nodes[nodeId];
+	const Node& child1 = m_nodes[node.child1];
+	const Node& child2 = m_nodes[node.child2];
+
+	node.box = child1.box.merge(child2.box);
+	node.height = 1 + std::max(child1.height, child2.height);
+	node.layers = child1.layers | child2.layers;
+}
+
+bool DynamicAabbTree::contains(const CollisionRectangle& outer, const CollisionRectangle& inner)
+{
+	return outer.m_xPos <= inner.m_xPos &&
+		outer.m_yPos <= inner.m_yPos &&
+		inner.m_xPos + inner.m_width <= outer.m_xPos + outer.m_width &&
+		inner.m_yPos + inner.m_height <= outer.m_yPos + outer.m_height;
+}
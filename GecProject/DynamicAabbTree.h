@@ -0,0 +1,179 @@
+#pragma once
+#include "CollisionRectangle.h"
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+class Entity;
+
+// A bounding volume hierarchy for entities that move every tick (the player, enemies and bullets)
+// Each leaf stores a "fat" box - the hitbox grown by a margin - so small moves don't need the tree to be touched at all,
+// and the tree is kept balanced with rotations so queries stay logarithmic as the number of bodies grows
+// Every node also stores the collision layers found below it, so queries skip whole subtrees their mask excludes
+class DynamicAabbTree
+{
+public:
+	static constexpr int NullNode = -1;
+
+	explicit DynamicAabbTree(float fatMargin = 4.f) : m_fatMargin(fatMargin) {}
+
+	void clear(); // Removes every proxy
+	void reserve(int proxyCount); // Makes room for that many proxies, so creating them doesn't allocate
+
+	int createProxy(const CollisionRectangle& hitbox, Entity* entity, std::uint32_t layer); // Adds a leaf for the entity, returns its proxy ID
+	void destroyProxy(int proxyId);
+
+	// Updates a proxy after its entity has moved. Only reinserts it if the hitbox left the fat box, returning whether it did
+	bool moveProxy(int proxyId, const CollisionRectangle& hitbox, sf::Vector2f displacement);
+
+	Entity* getEntity(int proxyId) const { return m_nodes[proxyId].entity; }
+	const CollisionRectangle& getFatBox(int proxyId) const { return m_nodes[proxyId].box; }
+
+	int getProxyCount() const { return m_proxyCount; }
+	int getHeight() const { return m_root == NullNode ? 0 : m_nodes[m_root].height; }
+
+	// Calls callback(proxyId) for every proxy on a layer in the mask whose fat box overlaps the area. The callback returns false to stop the query early
+	template<typename Callback>
+	void query(const CollisionRectangle& area, std::uint32_t mask, Callback&& callback) const;
+
+	// Calls callback(proxyId, maxFraction) for every proxy on a layer in the mask whose fat box the segment from -> to passes through
+	// The callback returns the fraction (0 - 1) of the segment still worth searching, letting it clip the ray to the closest hit so far.
+	// Returning 0 stops the cast
+	template<typename Callback>
+	void rayCast(sf::Vector2f from, sf::Vector2f to, std::uint32_t mask, Callback&& callback) const;
+private:
+	struct Node
+	{
+		CollisionRectangle box; // The fat box for leaves, the union of the children for branches
+		Entity* entity{ nullptr }; // Only set for leaves
+		std::uint32_t layers{ 0 }; // The leaf's layer, or the layers of every leaf below a branch
+
+		int parent{ NullNode }; // Doubles as the next free node when the node is unused
+		int child1{ NullNode };
+		int child2{ NullNode };
+		int height{ -1 }; // Leaves are 0, free nodes are -1
+
+		bool isLeaf() const { return child1 == NullNode; }
+	};
+
+	int allocateNode();
+	void freeNode(int nodeId);
+
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	int balance(int nodeId); // Performs a rotation if the node is unbalanced, returns the node now in its place
+	void refit(int nodeId); // Recalculates a branch's box, height and layers from its children
+
+	static float perimeter(const CollisionRectangle& box) { return 2.f * (box.m_width + box.m_height); }
+	static bool contains(const CollisionRectangle& outer, const CollisionRectangle& inner);
+
+	static constexpr int StackSize = 256; // Traversal stack depth, far deeper than a balanced tree will ever get
+
+	float m_fatMargin; // How far each leaf's box is grown past the hitbox
+
+	std::vector<Node> m_nodes;
+	int m_root{ NullNode };
+	int m_freeList{ NullNode };
+	int m_proxyCount{ 0 };
+};
+
+template<typename Callback>
+void DynamicAabbTree::query(const CollisionRectangle& area, std::uint32_t mask, Callback&& callback) const
+{
+	int stack[StackSize];
+	int count = 0;
+
+	if (m_root != NullNode)
+		stack[count++] = m_root;
+
+	while (count > 0)
+	{
+		int nodeId = stack[--count];
+		const Node& node = m_nodes[nodeId];
+
+		if ((node.layers & mask) == 0) continue; // Nothing below here is on a layer we care about
+		if (!node.box.intersection(area)) continue; // Nothing below here can overlap
+
+		if (node.isLeaf())
+		{
+			if (!callback(nodeId))
+				return; // The caller has found what it needed
+		}
+		else
+		{
+			assert(count + 2 <= StackSize);
+			stack[count++] = node.child1;
+			stack[count++] = node.child2;
+		}
+	}
+}
+
+template<typename Callback>
+void DynamicAabbTree::rayCast(sf::Vector2f from, sf::Vector2f to, std::uint32_t mask, Callback&& callback) const
+{
+	sf::Vector2f delta = to - from;
+	float maxFraction = 1.f;
+
+	int stack[StackSize];
+	int count = 0;
+
+	if (m_root != NullNode)
+		stack[count++] = m_root;
+
+	while (count > 0)
+	{
+		int nodeId = stack[--count];
+		const Node& node = m_nodes[nodeId];
+
+		if ((node.layers & mask) == 0) continue; // Nothing below here is on a layer we care about
+
+		// Slab test of the segment (clipped to maxFraction) against the node's box
+		float tMin = 0.f;
+		float tMax = maxFraction;
+		bool hit = true;
+
+		const float origin[2] = { from.x, from.y };
+		const float direction[2] = { delta.x, delta.y };
+		const float boxMin[2] = { node.box.m_xPos, node.box.m_yPos };
+		const float boxMax[2] = { node.box.m_xPos + node.box.m_width, node.box.m_yPos + node.box.m_height };
+
+		for (int axis = 0; axis < 2 && hit; ++axis)
+		{
+			if (direction[axis] == 0.f)
+			{
+				// Parallel to this axis, so must already be between the slabs
+				if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+					hit = false;
+			}
+			else
+			{
+				float t1 = (boxMin[axis] - origin[axis]) / direction[axis];
+				float t2 = (boxMax[axis] - origin[axis]) / direction[axis];
+				if (t1 > t2) std::swap(t1, t2);
+
+				if (t1 > tMin) tMin = t1;
+				if (t2 < tMax) tMax = t2;
+				if (tMin > tMax) hit = false;
+			}
+		}
+
+		if (!hit) continue;
+
+		if (node.isLeaf())
+		{
+			float fraction = callback(nodeId, maxFraction);
+			if (fraction <= 0.f)
+				return; // The caller asked to stop
+
+			if (fraction < maxFraction)
+				maxFraction = fraction; // Clips the ray to the closest hit so far
+		}
+		else
+		{
+			assert(count + 2 <= StackSize);
+			stack[count++] = node.child1;
+			stack[count++] = node.child2;
+		}
+	}
+}
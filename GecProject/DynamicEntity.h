@@ -1,26 +1,105 @@
 #pragma once
 #include "Entity.h"
+#include "PhysicsStore.h"
+#include "TimerWheel.h"
 
 // Entity that is affected by physics, gravity and/or velocity
+// Its position, velocity and grounded state live in the simulation's PhysicsStore, so the physics passes can run over them contiguously
 class DynamicEntity : public Entity
 {
 public:
-	using Entity::Entity; // Inherit constructors
+	DynamicEntity(PhysicsStore& store, const Animation& animation, EntityType type = EntityType::Standard)
+		: Entity(animation, type), m_store(&store)
+	{
+		m_bodyIndex = m_store->add(this, m_hitbox.m_width, m_hitbox.m_height, DefaultGravity);
+	}
+
+	DynamicEntity(PhysicsStore& store, const StaticSprite& sprite, EntityType type = EntityType::Standard)
+		: Entity(sprite, type), m_store(&store)
+	{
+		m_bodyIndex = m_store->add(this, m_hitbox.m_width, m_hitbox.m_height, DefaultGravity);
+	}
+
+	~DynamicEntity() override { m_store->remove(m_bodyIndex); }
+
+	// Each entity owns a single body in the store, so can't be copied
+	DynamicEntity(const DynamicEntity&) = delete;
+	DynamicEntity& operator=(const DynamicEntity&) = delete;
 
-	virtual void update(float deltaTime) override
+	// Hides the sprite's versions, so the body in the store always moves with the entity
+	// Being moved directly wakes the body, as it may no longer be resting on anything
+	void setPosition(sf::Vector2f position)
+	{
+		m_store->wake(m_bodyIndex);
+		m_store->m_x[m_bodyIndex] = position.x;
+		m_store->m_y[m_bodyIndex] = position.y;
+		Entity::setPosition(position);
+	}
+
+	void move(sf::Vector2f offset) { setPosition(getPosition() + offset); }
+
+	// Any change of velocity wakes a sleeping body - setting the same velocity each tick, like a stationary enemy does, doesn't
+	void setVelocity(sf::Vector2f velocity)
+	{
+		setVelocityX(velocity.x);
+		setVelocityY(velocity.y);
+	}
+	void setVelocityX(float velocityX)
+	{
+		if (m_store->m_velocityX[m_bodyIndex] != velocityX) m_store->wake(m_bodyIndex);
+		m_store->m_velocityX[m_bodyIndex] = velocityX;
+	}
+	void setVelocityY(float velocityY)
 	{
-		m_velocity.y += m_gravity * deltaTime; // Applies gravity to the player's vertical velocity, so they fall
+		if (m_store->m_velocityY[m_bodyIndex] != velocityY) m_store->wake(m_bodyIndex);
+		m_store->m_velocityY[m_bodyIndex] = velocityY;
+	}
+	sf::Vector2f getVelocity() const { return { m_store->m_velocityX[m_bodyIndex], m_store->m_velocityY[m_bodyIndex] }; }
+
+	// Gravity is applied to every body at once by PhysicsStore::integrate, so is a per-body setting rather than an update override
+	void setGravity(float gravity) { m_store->m_gravity[m_bodyIndex] = gravity; }
+	float getGravity() const { return m_store->m_gravity[m_bodyIndex]; }
+
+	void setIsGrounded(bool grounded) { m_store->setFlag(m_bodyIndex, BodyFlags::Grounded, grounded); } // Sets the entity as "on the ground", doesn't actually move it
+	bool isGrounded() const { return m_store->hasFlag(m_bodyIndex, BodyFlags::Grounded); } // Check for whether the entity is on the ground
+
+	bool isSleeping() const { return m_store->isSleeping(m_bodyIndex); }
+	void wake() { m_store->wake(m_bodyIndex); }
+
+	// Set by the simulation when the entity leaves or enters its activation region
+	bool isFrozen() const { return m_store->isFrozen(m_bodyIndex); }
+	void setFrozen(bool frozen) { m_store->setFrozen(m_bodyIndex, frozen); }
+
+	// Where the entity's body lives in the store, updated by the store when bodies are swapped on removal
+	void setBodyIndex(int bodyIndex) { m_bodyIndex = bodyIndex; }
+	int getBodyIndex() const { return m_bodyIndex; }
 
-		Entity::update(deltaTime); // Calls the base class update to handle animation and movement
+	// Copies the body's resolved position onto the sprite and hitbox, called by PhysicsStore::scatter
+	void syncFromStore(float x, float y)
+	{
+		Entity::setPosition({ x, y });
+		this->syncHitbox();
 	}
 
-	void setVelocity(sf::Vector2f velocity) { m_velocity = velocity; }
-	const sf::Vector2f& getVelocity() const { return m_velocity; }
+	// The entity's leaf in the simulation's dynamic AABB tree, -1 when it isn't in the tree
+	void setProxyId(int proxyId) { m_proxyId = proxyId; }
+	int getProxyId() const { return m_proxyId; }
 
-	void setIsGrounded(bool grounded) { m_grounded = grounded; } // Sets the entity as "on the ground", doesn't actually move it
-	bool isGrounded() const { return m_grounded; } // Check for whether the entity is on the ground
+	void setTimers(TimerWheel* timers) { m_timers = timers; } // Sets the simulation's timer wheel, used for cooldowns
 protected:
-	sf::Vector2f m_velocity{ 0.f, 0.f };
-	float m_gravity{ 980.f }; // Gravity affecting the entity
-	bool m_grounded{ false }; // Whether the entity is on the ground
-};
\ No newline at end of file
+	PhysicsStore* m_store{ nullptr };
+	int m_bodyIndex{ -1 };
+
+	// A cooldown is a timer with no callback - nothing counts it down, it is cooling down while the timer is pending
+	void startCooldown(TimerHandle& cooldown, float seconds)
+	{
+		if (m_timers) cooldown = m_timers->schedule(m_timers->ticksFor(seconds));
+	}
+	bool isCoolingDown(const TimerHandle& cooldown) const { return m_timers && m_timers->isPending(cooldown); }
+
+	TimerWheel* m_timers{ nullptr };
+
+	static constexpr float DefaultGravity = 980.f; // Gravity affecting the entity, unless it sets its own
+
+	int m_proxyId{ -1 };
+};
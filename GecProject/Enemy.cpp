@@ -1,14 +1,14 @@
 #include "Enemy.h"
 #include <cmath>
 
-Enemy::Enemy(const AnimationManager& animManager, float patrolRange)
-    : DynamicEntity(animManager.getAnimation("playerWalk"), EntityType::Enemy), m_patrolRange(patrolRange)
+Enemy::Enemy(PhysicsStore& store, const AnimationManager& animManager, float patrolRange)
+    : DynamicEntity(store, animManager.getAnimation("playerWalk"), EntityType::Enemy), m_patrolRange(patrolRange)
 {
 	m_playerIdle = &animManager.getAnimation("playerIdle");
     m_playerWalk = &animManager.getAnimation("playerWalk");
     m_playerStandingShot = &animManager.getAnimation("playerStandingShot");
 
-	m_velocity.x = -m_speed; // Sets the enemy to move left initially, as this will typically lead them towards the player
+	setVelocityX(-m_speed); // Sets the enemy to move left initially, as this will typically lead them towards the player
 }
 
 void Enemy::update(float deltaTime)
@@ -19,10 +19,6 @@ void Enemy::update(float deltaTime)
         m_hasSetStartPos = true;
     }
 
-    // Shoot Cooldown Timer
-    if (m_shootTimer > 0.f)
-        m_shootTimer -= deltaTime;
-
     // State Management
     if (canSeePlayer()) // If player is visible, attack
     {
@@ -36,7 +32,7 @@ void Enemy::update(float deltaTime)
     // State Behaviors
     if (m_state == State::Attacking) // Attack Behavior
     {
-        m_velocity.x = 0.f; // Stops the enemy from moving, whilst attacking
+        setVelocityX(0.f); // Stops the enemy from moving, whilst attacking
 
         // Change Animation to Shooting
         if (m_animation != m_playerStandingShot)
@@ -49,12 +45,12 @@ void Enemy::update(float deltaTime)
             if (m_animation != m_playerIdle)
                 setAnimation(*m_playerIdle);
 
-            m_velocity.x = 0.f; // Force stop
+            setVelocityX(0.f); // Force stop
 
             // Checks which way to face based on player position
-            if (m_target)
+            if (const PlayerEntity* target = getTarget())
             {
-                float diffX = m_target->getPosition().x - getPosition().x; // Difference in X positions
+                float diffX = target->getPosition().x - getPosition().x; // Difference in X positions
 
                 // Check if player is within vision range
                 if (std::abs(diffX) < m_visionRangeX)
@@ -73,31 +69,31 @@ void Enemy::update(float deltaTime)
 
             // Restore velocity based on which way we were trying to go
             // (This logic ensures we don't get stuck standing still after an attack)
-            if (m_velocity.x == 0.f)
-                m_velocity.x = (m_speed > 0) ? std::abs(m_speed) : -std::abs(m_speed);
+            if (getVelocity().x == 0.f)
+                setVelocityX((m_speed > 0) ? std::abs(m_speed) : -std::abs(m_speed));
 
-            if (std::abs(m_velocity.x) < 0.1f) // Enemy has stopped due to a collision, turn around
+            if (std::abs(getVelocity().x) < 0.1f) // Enemy has stopped due to a collision, turn around
             {
                 m_speed = -m_speed; // Reverse direction
-                m_velocity.x = m_speed; // Apply new velocity
+                setVelocityX(m_speed); // Apply new velocity
             }
-            else if (m_velocity.x > 0 && getPosition().x > m_startX + m_patrolRange) // Moving right and exceeded patrol range
+            else if (getVelocity().x > 0 && getPosition().x > m_startX + m_patrolRange) // Moving right and exceeded patrol range
             {
                 m_speed = -std::abs(m_speed); // Ensure speed is negative
-                m_velocity.x = m_speed; // Apply new velocity
+                setVelocityX(m_speed); // Apply new velocity
             }
-            else if (m_velocity.x < 0 && getPosition().x < m_startX - m_patrolRange) // Moving left and exceeded patrol range
+            else if (getVelocity().x < 0 && getPosition().x < m_startX - m_patrolRange) // Moving left and exceeded patrol range
             {
                 m_speed = std::abs(m_speed); // Ensure speed is positive
-                m_velocity.x = m_speed; // Apply new velocity
+                setVelocityX(m_speed); // Apply new velocity
             }
             else // No collision and inside patrol range
-                m_velocity.x = (m_speed > 0) ? std::abs(m_speed) : -std::abs(m_speed); // Maintain current direction
+                setVelocityX((m_speed > 0) ? std::abs(m_speed) : -std::abs(m_speed)); // Maintain current direction
 
             // Sprite Flipper
-            if (m_velocity.x < 0)
+            if (getVelocity().x < 0)
                 this->flipSprite(true);
-            else if (m_velocity.x > 0)
+            else if (getVelocity().x > 0)
                 this->flipSprite(false);
         }
     }
@@ -112,20 +108,22 @@ void Enemy::update(float deltaTime)
 void Enemy::turnAround()
 {
 	m_speed = -m_speed; // Reverse direction
-	m_velocity.x = -m_velocity.x; // Apply new velocity
+	setVelocityX(-getVelocity().x); // Apply new velocity
 
 	// Sprite Flipper
-    if (m_velocity.x < 0) this->flipSprite(true);
+    if (getVelocity().x < 0) this->flipSprite(true);
     else this->flipSprite(false);
 }
 
 // Attempts to shoot a projectile, returns true if successful
 bool Enemy::tryShoot(sf::Vector2f& direction)
 {
+    const PlayerEntity* target = getTarget();
+
     // Checks whether the enemy wants to shoot and if the cooldown timer has elapsed
-    if (m_state == State::Attacking && m_shootTimer <= 0.f)
+    if (target && m_state == State::Attacking && !isCoolingDown(m_shootTimer))
     {
-        m_shootTimer = m_shootCooldown; // Sets a cooldown of 0.5 seconds between shots
+        startCooldown(m_shootTimer, m_shootCooldown); // Sets a cooldown of 0.65 seconds between shots
 
         sf::Vector2f myPos = getPosition();
 
@@ -136,7 +134,7 @@ bool Enemy::tryShoot(sf::Vector2f& direction)
 
         sf::Vector2f gunPos = { myPos.x + xOffset, myPos.y + yOffset };
 
-		sf::Vector2f targetPos = m_target->getPosition(); // Player position used for comparison
+		sf::Vector2f targetPos = target->getPosition(); // Player position used for comparison
 		sf::Vector2f difference = targetPos - gunPos; // Difference vector from gun to player
 
 		// Calculate the length of the difference vector, using square root as its more accurate for normalisation
@@ -167,10 +165,11 @@ void Enemy::takeDamage(int amount)
 
 bool Enemy::canSeePlayer() const
 {
-    if (!m_target) return false; // No target to see
+    const PlayerEntity* target = getTarget();
+    if (!target) return false; // No target to see, or it has been removed
 
 	sf::Vector2f myPos = getPosition(); // Enemy position used for comparison
-	sf::Vector2f targetPos = m_target->getPosition(); // Player position used for comparison
+	sf::Vector2f targetPos = target->getPosition(); // Player position used for comparison
 
     // Check Horizontal Distance
     if (std::abs(targetPos.x - myPos.x) > m_visionRangeX) return false; // Too far away
@@ -183,9 +182,11 @@ bool Enemy::canSeePlayer() const
     bool amIFacingLeft = m_flipped;
     bool isPlayerLeft = (targetPos.x < myPos.x);
 
-	// If facing the player, can see them
-    if (amIFacingLeft && isPlayerLeft) return true;
-    if (!amIFacingLeft && !isPlayerLeft) return true;
+    if (amIFacingLeft != isPlayerLeft) return false; // Player is behind the enemy
+
+	// Facing the player, so can see them unless a wall is in the way - checked last as it's the most expensive test
+    TileRaycastHit hit;
+    if (m_world && m_world->raycast(myPos.x, myPos.y, targetPos.x, targetPos.y, hit)) return false;
 
-    return false; // Player is behind the enemy
+    return true;
 }
@@ -1,17 +1,25 @@
 #pragma once
 #include "DynamicEntity.h"
 #include "PlayerEntity.h"
+#include "TileLayer.h"
+#include "EntityRegistry.h"
 
 class Enemy : public DynamicEntity
 {
 public:
-    explicit Enemy(const AnimationManager& animManager, float m_patrolRange = 150.f); // Uses the base class constructor
+    Enemy(PhysicsStore& store, const AnimationManager& animManager, float m_patrolRange = 150.f); // Uses the base class constructor
 
     void update(float deltaTime) override;
     
 	void turnAround(); // Forces the enemy to turn around when called
 
-	void setTarget(PlayerEntity* player) { m_target = player; } // Sets the player as the target for the enemy to track
+	// Sets the player as the target for the enemy to track - held by handle, so a removed player is never followed
+	void setTarget(const EntityRegistry<PlayerEntity>* players, EntityHandle player)
+	{
+		m_players = players;
+		m_target = player;
+	}
+	void setWorld(const TileLayer* world) { m_world = world; } // Sets the level's tiles, so the enemy can't see through walls
 
     bool tryShoot(sf::Vector2f& direction); // Returns whether the player's attempt to shoot was successful
 
@@ -24,13 +32,16 @@ private:
 	int m_health{ 2 }; // Enemy health
 
     bool canSeePlayer() const;
+    const PlayerEntity* getTarget() const { return m_players ? m_players->get(m_target) : nullptr; } // Null once the target is gone
 
     // Animations
 	const Animation* m_playerIdle{ nullptr };
     const Animation* m_playerWalk{ nullptr };
     const Animation* m_playerStandingShot{ nullptr };
 
-    PlayerEntity* m_target{ nullptr };
+    const EntityRegistry<PlayerEntity>* m_players{ nullptr };
+    EntityHandle m_target;
+    const TileLayer* m_world{ nullptr };
 
     enum class State { Patrolling, Attacking }; // Enemy States
 	State m_state{ State::Patrolling }; // Current enemy state
@@ -40,7 +51,7 @@ private:
     float m_visionRangeX{ 200.f };
     float m_visionRangeY{ 180.f };
 
-    float m_shootTimer{ 0.f };
+    TimerHandle m_shootTimer;
     float m_shootCooldown{ 0.65f }; // Time between being able to shoot again
 
     float m_speed{ 50.f }; // Enemy movement speed
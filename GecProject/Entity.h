@@ -1,6 +1,8 @@
 #pragma once
 #include "AnimationManager.h"
 #include "CollisionRectangle.h"
+#include "CollisionLayers.h"
+#include "EntityRegistry.h"
 #include <SFML/Graphics.hpp>
 
 // Used to differentiate between different entity types within the game world, primarily for collision handling
@@ -11,7 +13,8 @@ enum class EntityType
     Collectable,
     Bullet,
     Enemy,
-    Door
+    Door,
+    Platform
 };
 
 // Our base class for entities within our game world, inherits from sf::Sprite to allow easy drawing and manipulation of sprites
@@ -54,7 +57,7 @@ public:
         m_animation = &animation;
         this->setTexture(*m_animation->texture, true);
 		m_currentFrame = 0; // Resets to the first frame
-        m_animClock.restart();
+        m_animTime = 0.f;
 		m_isAnimated = true; // Sets the entity as animated, not static
 
         // Calculates and sets the intRect for the first frame. Otherwise the entire spritesheet would be shown till it was set in update
@@ -82,7 +85,9 @@ public:
     virtual void update(float deltaTime)
     {
 		// After the set time, updates to the next sprite - if there is an animation set
-        if (m_isAnimated && m_animation && m_animClock.getElapsedTime().asSeconds() > m_animation->timeBetweenFrames)
+		// Counted in simulation time, so animations slow with the tick rate and stop while frozen
+        m_animTime += deltaTime;
+        if (m_isAnimated && m_animation && m_animTime > m_animation->timeBetweenFrames)
         {
             m_currentFrame++;
 
@@ -92,7 +97,7 @@ public:
                 m_currentFrame = 0;
             }
 
-            m_animClock.restart();
+            m_animTime = 0.f;
         }
 
         if (m_animation)
@@ -131,6 +136,29 @@ public:
     EntityType getType() const { return m_type; } 
 	const CollisionRectangle& getHitbox() const { return m_hitbox; } // Returns the hitbox of the entity for collision detection
 
+	// Sets which collision layer the entity is on, and the mask of layers it tests against - see CollisionFilter
+	void setCollisionLayer(std::uint32_t layer, std::uint32_t mask)
+	{
+		m_collisionLayer = layer;
+		m_collisionMask = mask;
+	}
+	std::uint32_t getCollisionLayer() const { return m_collisionLayer; }
+	std::uint32_t getCollisionMask() const { return m_collisionMask; }
+
+	// Static entities (tiles and doors) never move or animate once created - they are skipped by the update and drawn without interpolation
+	// Marking one static also fixes its hitbox and previous position where it currently is, as neither will be updated again
+	void makeStatic()
+	{
+		syncHitbox();
+		m_previousPosition = this->getPosition();
+		m_isStatic = true;
+	}
+	bool isStatic() const { return m_isStatic; }
+
+	// The entity's handle in the EntityRegistry that owns it, if one does - set by the registry as it is added
+	EntityHandle getHandle() const { return m_handle; }
+	void setHandle(EntityHandle handle) { m_handle = handle; }
+
 	// For interpolation - to help with smooth movement
     void setPreviousPosition(sf::Vector2f pos) { m_previousPosition = pos; }
     sf::Vector2f getPreviousPosition() const { return m_previousPosition; }
@@ -139,14 +167,19 @@ protected:
     EntityType m_type;
     CollisionRectangle m_hitbox; // The hitbox for the entity, used for collision detection
 
+    std::uint32_t m_collisionLayer{ CollisionLayers::None };
+    std::uint32_t m_collisionMask{ CollisionLayers::None };
+
     bool m_destroy{ false };
+    bool m_isStatic{ false };
 
     bool m_flipped{ false };
     void flipSprite(bool flipped) { m_flipped = flipped; }
 private:
+	EntityHandle m_handle;
 	sf::Vector2f m_previousPosition; // For interpolation - to help with smooth movement
 
-    sf::Clock m_animClock;
+    float m_animTime{ 0.f }; // Time spent on the current frame
     int m_currentFrame{ 0 };
     bool m_isAnimated{ false };
 };
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Refers to an entity in an EntityRegistry - stays safe to hold after the entity is removed, it just stops resolving
+struct EntityHandle
+{
+	int index{ -1 };
+	std::uint32_t generation{ 0 };
+
+	bool operator==(const EntityHandle&) const = default;
+};
+
+// Owns entities of one type, handing out generational handles to them
+// The entities are kept packed together for iterating, and each handle's slot records where its entity currently is
+// Removing swaps the last entity into the gap, so is O(1) however many there are, and bumps the slot's generation so old handles go stale
+// Registered entities are told their own handle, so anything holding just the entity can still have it removed
+template<typename T>
+class EntityRegistry
+{
+public:
+	EntityHandle add(std::unique_ptr<T> entity);
+	void remove(EntityHandle handle); // Destroys the entity if the handle is still live, otherwise does nothing
+	void clear(); // Destroys every entity, leaving all their handles stale
+
+	T* get(EntityHandle handle) const; // The entity, or nullptr if the handle is stale
+	bool isAlive(EntityHandle handle) const { return get(handle) != nullptr; }
+
+	void reserve(std::size_t count);
+
+	// Iterates the entities themselves, in no particular order - removing moves the last one into the gap
+	auto begin() const { return m_entities.begin(); }
+	auto end() const { return m_entities.end(); }
+	std::size_t size() const { return m_entities.size(); }
+	bool empty() const { return m_entities.empty(); }
+private:
+	// Where a handle's entity is in the packed list
+	struct Slot
+	{
+		int entity{ -1 }; // Index into m_entities, -1 while free
+		std::uint32_t generation{ 0 }; // Bumped whenever the slot is freed, so old handles stop matching
+	};
+
+	std::vector<std::unique_ptr<T>> m_entities; // Packed, so iterating never skips over gaps
+	std::vector<int> m_entitySlots; // The slot of each packed entity, to fix up its slot when it is moved
+	std::vector<Slot> m_slots;
+	std::vector<int> m_freeSlots;
+};
+
+template<typename T>
+EntityHandle EntityRegistry<T>::add(std::unique_ptr<T> entity)
+{
+	int slot;
+	if (!m_freeSlots.empty())
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slot = static_cast<int>(m_slots.size());
+		m_slots.emplace_back();
+	}
+
+	EntityHandle handle{ slot, m_slots[slot].generation };
+	entity->setHandle(handle);
+
+	m_slots[slot].entity = static_cast<int>(m_entities.size());
+	m_entities.push_back(std::move(entity));
+	m_entitySlots.push_back(slot);
+
+	return handle;
+}
+
+template<typename T>
+void EntityRegistry<T>::remove(EntityHandle handle)
+{
+	if (!isAlive(handle)) return;
+
+	Slot& slot = m_slots[handle.index];
+	int last = static_cast<int>(m_entities.size()) - 1;
+
+	// The last entity fills the gap, and its slot is pointed at where it went
+	if (slot.entity != last)
+	{
+		m_entities[slot.entity] = std::move(m_entities[last]);
+		m_entitySlots[slot.entity] = m_entitySlots[last];
+		m_slots[m_entitySlots[slot.entity]].entity = slot.entity;
+	}
+
+	m_entities.pop_back();
+	m_entitySlots.pop_back();
+
+	slot.entity = -1;
+	slot.generation++;
+	m_freeSlots.push_back(handle.index);
+}
+
+template<typename T>
+void EntityRegistry<T>::clear()
+{
+	for (int index = 0; index < static_cast<int>(m_slots.size()); ++index)
+	{
+		Slot& slot = m_slots[index];
+		if (slot.entity == -1) continue; // Already free, and already in the free list
+
+		slot.entity = -1;
+		slot.generation++;
+		m_freeSlots.push_back(index);
+	}
+
+	m_entities.clear();
+	m_entitySlots.clear();
+}
+
+template<typename T>
+T* EntityRegistry<T>::get(EntityHandle handle) const
+{
+	if (handle.index < 0 || handle.index >= static_cast<int>(m_slots.size())) return nullptr;
+
+	const Slot& slot = m_slots[handle.index];
+	if (slot.entity == -1 || slot.generation != handle.generation) return nullptr;
+
+	return m_entities[slot.entity].get();
+}
+
+template<typename T>
+void EntityRegistry<T>::reserve(std::size_t count)
+{
+	m_entities.reserve(count);
+	m_entitySlots.reserve(count);
+	m_slots.reserve(count);
+	m_freeSlots.reserve(count);
+}
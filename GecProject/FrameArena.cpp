@@ -0,0 +1,67 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <bit>
+#include <new>
+
+FrameArena::FrameArena(std::size_t capacity) :
+	m_buffer(static_cast<std::byte*>(::operator new(capacity, std::align_val_t{ alignof(std::max_align_t) }))),
+	m_capacity(capacity)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	freeOverflow();
+	::operator delete(m_buffer, std::align_val_t{ alignof(std::max_align_t) });
+}
+
+void FrameArena::reset()
+{
+	m_highWater = std::max(m_highWater, m_used);
+
+	if (m_overflow)
+	{
+		freeOverflow();
+		m_overflowCount++;
+
+		// Grown to fit the most any tick has needed, so the heap is only touched again if a tick needs even more
+		::operator delete(m_buffer, std::align_val_t{ alignof(std::max_align_t) });
+		m_capacity = std::bit_ceil(m_highWater);
+		m_buffer = static_cast<std::byte*>(::operator new(m_capacity, std::align_val_t{ alignof(std::max_align_t) }));
+	}
+
+	m_offset = 0;
+	m_used = 0;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	std::size_t start = (m_offset + alignment - 1) & ~(alignment - 1); // Alignments are always powers of two
+
+	if (start + bytes <= m_capacity)
+	{
+		m_used += bytes + (start - m_offset);
+		m_offset = start + bytes;
+		return m_buffer + start;
+	}
+
+	// Doesn't fit, so comes from its own heap block, with the allocation placed after the block's header
+	m_used += bytes;
+
+	std::size_t blockAlignment = std::max(alignment, alignof(OverflowBlock));
+	std::size_t headerSize = std::max(sizeof(OverflowBlock), alignment);
+	std::byte* block = static_cast<std::byte*>(::operator new(headerSize + bytes, std::align_val_t{ blockAlignment }));
+
+	m_overflow = new (block) OverflowBlock{ m_overflow, blockAlignment };
+	return block + headerSize;
+}
+
+void FrameArena::freeOverflow()
+{
+	while (m_overflow)
+	{
+		OverflowBlock* block = m_overflow;
+		m_overflow = block->previous;
+		::operator delete(block, std::align_val_t{ block->alignment });
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+// Linear bump allocator for data that only lives for one simulation tick, used through std::pmr containers
+// Allocating just moves a pointer along one buffer, freeing does nothing, and reset rewinds the whole lot at once
+// Anything that doesn't fit comes from the heap until the next reset, which then grows the buffer so later ticks fit
+// Not thread safe - only the serial phases of a tick allocate from it
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+	explicit FrameArena(std::size_t capacity = 64 * 1024);
+	~FrameArena() override;
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Rewinds to the start of the buffer - every container still holding arena memory must have dropped it first
+	void reset();
+
+	std::size_t getUsed() const { return m_used; } // Bytes handed out since the last reset, including any overflow
+	std::size_t getCapacity() const { return m_capacity; }
+	std::size_t getHighWater() const { return m_used > m_highWater ? m_used : m_highWater; } // The most used between any two resets
+	int getOverflowCount() const { return m_overflowCount; } // How many resets found the buffer had overflowed
+protected:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void*, std::size_t, std::size_t) override {} // Everything is freed together by reset
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+private:
+	// Heads each heap block allocated on overflow, linking them so reset can free them
+	struct OverflowBlock
+	{
+		OverflowBlock* previous;
+		std::size_t alignment; // What the block was allocated with, which freeing it has to match
+	};
+
+	void freeOverflow();
+
+	std::byte* m_buffer{ nullptr };
+	std::size_t m_capacity{ 0 };
+	std::size_t m_offset{ 0 }; // Where the next allocation in the buffer starts
+
+	OverflowBlock* m_overflow{ nullptr };
+
+	std::size_t m_used{ 0 };
+	std::size_t m_highWater{ 0 };
+	int m_overflowCount{ 0 };
+};
@@ -1,11 +1,13 @@
 #include "Graphics.h"
 #include "ExternalHeaders.h"
+#include "Benchmarks.h"
+#include <cmath>
 
 /*
     Use IMGUI for a simple on screen GUI
     See: https://github.com/ocornut/imgui/wiki/
 */
-void DefineGUI(float fps)
+void DefineGUI(float fps, float& fixedTimestep, Simulation& simulation, const JobSystem& jobSystem, std::uint64_t tickAllocations, std::uint64_t renderAllocations)
 {
     // Show a simple window that we create ourselves. We use a Begin/End pair to created a named window.
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
@@ -14,6 +16,94 @@ void DefineGUI(float fps)
 
     ImGui::Text("%.2f FPS", fps); // Displays the FPS to two decimal places
 
+    // Heap allocations - a running game should make none, so anything here is worth finding
+    if (AllocationCounter::Enabled)
+        ImGui::Text("Allocations: %llu last tick, %llu last render", static_cast<unsigned long long>(tickAllocations), static_cast<unsigned long long>(renderAllocations));
+    else
+        ImGui::TextDisabled("Allocations: not counted, build with GEC_COUNT_ALLOCATIONS");
+
+    // Physics tick rate - bullets and bodies are swept, so lowering it trades smoothness for performance rather than correctness
+    int tickRate = static_cast<int>(std::round(1.f / fixedTimestep));
+    if (ImGui::SliderInt("Tick rate (Hz)", &tickRate, 15, 120))
+        fixedTimestep = 1.f / static_cast<float>(tickRate);
+
+    ImGui::Text("Colliders: %d tiles merged into %d", simulation.getSolidTileCount(), static_cast<int>(simulation.m_solidColliders.size()));
+    ImGui::Text("Bodies: %d awake, %d sleeping, %d frozen", simulation.getAwakeBodyCount(), simulation.getSleepingBodyCount(), simulation.getFrozenBodyCount());
+    ImGui::Text("Timers: %d pending, %d fired last tick", simulation.getTimers().getPendingCount(), simulation.getTimers().getFiredCount());
+
+    // Tick-scoped lists - the high water is the most any tick has used, the buffer grows to it after a tick overflows
+    const FrameArena& frameArena = simulation.getFrameArena();
+    ImGui::Text("Frame arena: %.1f KB last tick, %.1f KB high water, %.0f KB buffer, %d overflows", frameArena.getUsed() / 1024.f,
+        frameArena.getHighWater() / 1024.f, frameArena.getCapacity() / 1024.f, frameArena.getOverflowCount());
+
+    // Activation region - entities further than the margin from the view are frozen
+    bool activationEnabled = simulation.isActivationEnabled();
+    if (ImGui::Checkbox("Activation region", &activationEnabled))
+        simulation.setActivationEnabled(activationEnabled);
+
+    float activationMargin = simulation.getActivationMargin();
+    if (ImGui::SliderFloat("Activation margin", &activationMargin, 0.f, 320.f, "%.0f px"))
+        simulation.setActivationMargin(activationMargin);
+
+    ImGui::Text("Active: %d/%d enemies, %d/%d collectables", simulation.getActiveEnemyCount(), simulation.getEnemyCount(),
+        simulation.getActiveCollectableCount(), simulation.getCollectableCount());
+
+    // Contacts found last tick, by kind
+    int contactCounts[static_cast<int>(ContactKind::Count)] = {};
+    for (const ContactEvent& contact : simulation.getContacts())
+        contactCounts[static_cast<int>(contact.kind)]++;
+
+    ImGui::Text("Contacts: %d collectable, %d door, %d player hit, %d enemy hit, %d hazard", contactCounts[static_cast<int>(ContactKind::PlayerCollectable)],
+        contactCounts[static_cast<int>(ContactKind::PlayerDoor)], contactCounts[static_cast<int>(ContactKind::BulletHitPlayer)], contactCounts[static_cast<int>(ContactKind::BulletHitEnemy)],
+        contactCounts[static_cast<int>(ContactKind::PlayerHazard)]);
+
+    // Trigger transitions found last tick, by kind, and who is inside each trigger now
+    int transitionCounts[static_cast<int>(TriggerTransition::Count)] = {};
+    for (const TriggerEvent& event : simulation.getTriggerEvents())
+        transitionCounts[static_cast<int>(event.transition)]++;
+
+    ImGui::Text("Trigger events: %d enter, %d stay, %d exit", transitionCounts[static_cast<int>(TriggerTransition::Enter)],
+        transitionCounts[static_cast<int>(TriggerTransition::Stay)], transitionCounts[static_cast<int>(TriggerTransition::Exit)]);
+
+    for (const Trigger& trigger : simulation.getTriggerVolumes().getTriggers())
+        ImGui::BulletText("%s: %d inside", trigger.name.c_str(), trigger.occupants);
+
+    // Switching to a single thread is for comparison - the simulation behaves exactly the same either way
+    bool parallelUpdate = simulation.isParallelUpdate();
+    if (ImGui::Checkbox("Parallel behaviour update", &parallelUpdate))
+        simulation.setParallelUpdate(parallelUpdate);
+
+    // How busy each job system worker was over the last second - worker 0 is the main thread, only counted while it runs jobs
+    if (ImGui::CollapsingHeader("Job system"))
+    {
+        const std::vector<WorkerStats>& workerStats = jobSystem.getStats();
+        for (std::size_t i = 0; i < workerStats.size(); ++i)
+        {
+            const WorkerStats& stats = workerStats[i];
+            ImGui::Text("Worker %d: %3.0f%% busy, %d jobs (%d stolen)", static_cast<int>(i), stats.utilisation * 100.f, stats.jobCount, stats.stealCount);
+        }
+    }
+
+    // Broadphase debugging - shows how many pairs were tested last tick compared to scanning every entity
+    bool showBroadphaseStats = simulation.isBroadphaseStatsEnabled();
+    if (ImGui::Checkbox("Broadphase stats", &showBroadphaseStats))
+        simulation.setBroadphaseStatsEnabled(showBroadphaseStats);
+
+    if (showBroadphaseStats)
+    {
+        const BroadphaseStats& stats = simulation.getBroadphaseStats();
+        ImGui::Text("X pass pairs: %d", stats.xPassPairs);
+        ImGui::Text("Y pass pairs: %d", stats.yPassPairs);
+        ImGui::Text("Edge sensor pairs: %d", stats.edgeSensorPairs);
+        ImGui::Text("Bullet pairs: %d", stats.bulletPairs);
+        ImGui::Text("Total: %d (brute force: %d)", stats.total(), stats.bruteForcePairs);
+        ImGui::Text("Body tree: %d proxies, height %d", simulation.getBodyTree().getProxyCount(), simulation.getBodyTree().getHeight());
+    }
+
+    // Microbenchmarks of the physics hot paths, the results are printed to the console
+    if (ImGui::Button("Run benchmarks"))
+        Benchmarks::runAll();
+
     ImGui::End();
 }
 
@@ -21,7 +111,8 @@ void DefineGUI(float fps)
 Graphics::Graphics() :
     m_window(sf::VideoMode::getDesktopMode(), "GEC Start Project", sf::Style::Default),
 	m_gameView(sf::FloatRect({ 0.f, 0.f }, { 320, 180 })), // Sets the game view to a more readable resolution
-    m_simulation(m_textureManager),
+    m_textureManager(m_jobSystem),
+    m_simulation(m_textureManager, m_jobSystem),
     m_titleText(m_font),
     m_instructionText(m_font),
     m_scoreText(m_font),
@@ -60,6 +151,10 @@ void Graphics::initBg()
 
 void Graphics::initUI()
 {
+    // Trigger volume outlines, only the position, size and fill change per trigger
+    m_triggerVisualiser.setOutlineColor(sf::Color::Yellow);
+    m_triggerVisualiser.setOutlineThickness(-0.5f);
+
     // Loading the font
     if (!m_font.openFromFile("Data/arial.ttf"))
         std::cout << "ERROR: Could not load Data/arial.ttf" << std::endl;
@@ -128,7 +223,12 @@ void Graphics::drawHUD()
     // Resize the foreground (Green) bar (the actual health)
     m_healthBarFg.setSize({ maxWidth * widthRatio, m_healthBarBg.getSize().y });
 
-	m_hudScoreText.setString("Score: " + std::to_string(m_simulation.getScore())); // Updates the score text
+	// Updates the score text, only when the score changes as building the string allocates
+    if (m_simulation.getScore() != m_hudScore)
+    {
+        m_hudScore = m_simulation.getScore();
+        m_hudScoreText.setString("Score: " + std::to_string(m_hudScore));
+    }
 
     // Draws the HUD
     m_window.draw(m_healthBarBg);
@@ -157,11 +257,16 @@ void Graphics::display()
         }
 		else if (m_state == GameState::Ingame) // Ingame State
         {
+            m_simulation.setActivationView(sf::FloatRect(m_gameView.getCenter() - m_gameView.getSize() / 2.f, m_gameView.getSize())); // The simulated area follows the camera
+
             // Fixed timestep physics update loop
             m_accumulator += deltaTime;
             while (m_accumulator >= m_fixedTimestep)
             {
+                AllocationScope tickAllocations;
                 m_simulation.update(m_fixedTimestep); // Update the simulation with a fixed timestep
+                m_tickAllocations = tickAllocations.getCount();
+
                 m_accumulator -= m_fixedTimestep; // Decrease the accumulator by the fixed timestep
             }
 
@@ -188,7 +293,10 @@ void Graphics::display()
         }
 
         update(deltaTime);
+
+        AllocationScope renderAllocations;
         render();
+        m_renderAllocations = renderAllocations.getCount();
     }
 
     ImGui::SFML::Shutdown();
@@ -257,6 +365,7 @@ void Graphics::update(float deltaTime)
     if (m_frameClock.getElapsedTime().asSeconds() >= 1.0f)
     {
         m_fps = static_cast<float>(m_frameCount) / m_frameClock.getElapsedTime().asSeconds();
+        m_jobSystem.sampleStats(); // Sampled alongside the FPS, so the utilisation shown is over the same second
 		m_frameCount = 0; // Resets the frame count
         m_frameClock.restart();
     }
@@ -269,7 +378,7 @@ void Graphics::render()
     m_window.clear(sf::Color(139, 142, 135));
 
     // The UI gets defined each time
-    DefineGUI(m_fps);
+    DefineGUI(m_fps, m_fixedTimestep, m_simulation, m_jobSystem, m_tickAllocations, m_renderAllocations);
 
 	float alpha = m_accumulator / m_fixedTimestep; // Calculates the alpha for interpolation
 
@@ -356,9 +465,12 @@ void Graphics::render()
 				entity->setPosition(actualPos); // Returns the entity to its actual position for physics calculations (not visual)
             };
 
-        // Loops through the vector of entities created in the simulation, and draws them
-        for (const auto& entity : m_simulation.getEntities())
-			drawInterpolated(entity.get());
+        // Static entities never move, so are drawn where they are - only the moving ones need interpolating
+        for (Entity* entity : m_simulation.getStaticEntities())
+            m_window.draw(*entity);
+
+        for (Entity* entity : m_simulation.getMovingEntities())
+			drawInterpolated(entity);
 
         // Loops through the bullets and draws them
         for (const auto& bullet : m_simulation.getBullets())
@@ -368,9 +480,14 @@ void Graphics::render()
                 drawInterpolated(bullet.get(), sf::BlendAdd);
         }
 
-        // Debugging hitbox visualisers
-        for (auto& pair : m_simulation.m_triggerColliders)
-            m_window.draw(m_simulation.m_triggerHitboxVisualiser);
+        // Debugging hitbox visualisers - an outline per trigger volume, filled while something is inside it
+        for (const Trigger& trigger : m_simulation.getTriggerVolumes().getTriggers())
+        {
+            m_triggerVisualiser.setPosition({ trigger.area.m_xPos, trigger.area.m_yPos });
+            m_triggerVisualiser.setSize({ trigger.area.m_width, trigger.area.m_height });
+            m_triggerVisualiser.setFillColor(trigger.occupants > 0 ? sf::Color(255, 255, 0, 60) : sf::Color::Transparent);
+            m_window.draw(m_triggerVisualiser);
+        }
     }
 
 	// UI View
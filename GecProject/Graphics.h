@@ -1,5 +1,6 @@
 #pragma once
 #include "Simulation.h"
+#include "AllocationCounter.h"
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <optional>
@@ -31,6 +32,8 @@ private:
 	sf::RenderWindow m_window;
 	sf::View m_gameView;
 
+	JobSystem m_jobSystem; // Shared by the asset loading and the simulation - declared first, so its workers outlive both
+
 	TextureManager m_textureManager; // Passed into the simulation to be used by the animation manager
 	Simulation m_simulation;
 
@@ -39,13 +42,17 @@ private:
 
 	// Used for the physics update loop
 	float m_accumulator{ 0.f }; // Accumulates delta time
-	const float m_fixedTimestep{ 1.f / 60.f }; // Fixed timestep of 60 FPS, ensuring consistent physics updates
+	float m_fixedTimestep{ 1.f / 60.f }; // Fixed timestep of 60 FPS, ensuring consistent physics updates - adjustable from the GUI
 
 	// FPS counter variables
 	sf::Clock m_frameClock;
 	int m_frameCount{ 0 };
 	float m_fps{ 0.0f };
 
+	// Heap allocations made by the last simulation tick and the last render, zero unless built with GEC_COUNT_ALLOCATIONS
+	std::uint64_t m_tickAllocations{ 0 };
+	std::uint64_t m_renderAllocations{ 0 };
+
 	GameState m_state{ GameState::Frontend }; // Tracks the current game state
 
 	std::optional<sf::Sprite> m_backgroundSprite;
@@ -58,7 +65,10 @@ private:
 
 	// HUD Elements
 	sf::Text m_hudScoreText;
+	int m_hudScore{ -1 }; // The score the text was last built for
 	// Health Bar
 	sf::RectangleShape m_healthBarBg; // Health bar background
 	sf::RectangleShape m_healthBarFg; // Health bar foreground (what depletes)
+
+	sf::RectangleShape m_triggerVisualiser; // Debug outline, drawn once per trigger volume
 };
\ No newline at end of file
@@ -8,26 +8,32 @@ void InputManager::addListener(IReceivesInput* listener)
 
 void InputManager::update()
 {
-	std::vector<Actions> actions;
+	m_actions.clear(); // Keeps its capacity, so this never allocates
 
 	// Checks for key presses and adds them to to the actions vector - so the listeners can handle multiple inputs
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A))
-		actions.push_back(Actions::eMoveLeft);
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D))
-		actions.push_back(Actions::eMoveRight);
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space))
-		actions.push_back(Actions::eJump);
+	if (m_keyboardEnabled)
+	{
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A))
+			m_actions.push_back(Actions::eMoveLeft);
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D))
+			m_actions.push_back(Actions::eMoveRight);
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space))
+			m_actions.push_back(Actions::eJump);
+
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::E))
+			m_actions.push_back(Actions::eShoot);
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up))
+			m_actions.push_back(Actions::eLookUp);
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down))
+			m_actions.push_back(Actions::eLookDown);
+	}
 
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::E))
-		actions.push_back(Actions::eShoot);
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up))
-		actions.push_back(Actions::eLookUp);
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down))
-		actions.push_back(Actions::eLookDown);
+	m_actions.insert(m_actions.end(), m_simulatedActions.begin(), m_simulatedActions.end());
+	m_simulatedActions.clear();
 
 	// Loops through all listeners and handles the input - if there are any
 	for (IReceivesInput* listeners : m_listeners)
 	{
-		listeners->handleInput(actions);
+		listeners->handleInput(m_actions);
 	}
 }
\ No newline at end of file
@@ -7,7 +7,21 @@ class InputManager
 {
 private:
 	std::vector<IReceivesInput*> m_listeners;
+
+	// Refilled each update rather than rebuilt, so polling the input doesn't allocate once the game is running
+	std::vector<Actions> m_actions;
+	std::vector<Actions> m_simulatedActions;
+	bool m_keyboardEnabled{ true };
 public:
+	InputManager()
+	{
+		// Room for every action at once, so neither ever grows
+		m_actions.reserve(MaxActions * 2);
+		m_simulatedActions.reserve(MaxActions);
+	}
+
+	static constexpr std::size_t MaxActions = 7; // How many values Actions has
+
 	// Singleton pattern to ensure only one instance of InputManager exists
 	static InputManager& getInstance()
 	{
@@ -24,4 +38,8 @@ public:
 
 	void addListener(IReceivesInput* listener);
 	void update();
+
+	// Actions pressed by code rather than the keyboard, passed on with the next update - e.g. the allocation test playing the level
+	void simulateAction(Actions action) { m_simulatedActions.push_back(action); }
+	void setKeyboardEnabled(bool enabled) { m_keyboardEnabled = enabled; } // Turned off so a scripted run can't be disturbed
 };
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace
+{
+	// Which worker the current thread is, so jobs submitted from inside a job go on that worker's own queue
+	thread_local const JobSystem* t_jobSystem = nullptr;
+	thread_local int t_workerIndex = 0;
+}
+
+JobSystem::JobSystem(int workerCount)
+{
+	if (workerCount <= 0)
+		workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	for (int i = 0; i < workerCount; ++i)
+		m_workers.push_back(std::make_unique<Worker>());
+
+	m_stats.resize(workerCount);
+	m_lastSample = Clock::now();
+
+	// The creating thread is worker 0, every other worker gets a thread
+	t_jobSystem = this;
+	t_workerIndex = 0;
+
+	for (int i = 1; i < workerCount; ++i)
+		m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_running = false;
+	}
+	m_wake.notify_all();
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+
+	if (t_jobSystem == this)
+		t_jobSystem = nullptr;
+}
+
+void JobSystem::submit(std::function<void()> job, JobCounter* counter)
+{
+	if (counter)
+		counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+	push({ std::move(job), counter });
+}
+
+void JobSystem::submitAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter)
+{
+	if (counter)
+		counter->m_count.fetch_add(1, std::memory_order_relaxed); // Counted now, so waiting on it also waits for the dependency
+
+	{
+		std::lock_guard<std::mutex> lock(dependency.m_mutex);
+		if (!dependency.isDone())
+		{
+			dependency.m_continuations.push_back(std::move(job));
+			dependency.m_continuationCounters.push_back(counter);
+			return;
+		}
+	}
+
+	push({ std::move(job), counter });
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	int workerIndex = (t_jobSystem == this) ? t_workerIndex : 0;
+
+	while (!counter.isDone())
+	{
+		if (!tryRunJob(workerIndex))
+			std::this_thread::yield(); // Whatever is left is running on other workers
+	}
+
+	// The last job to finish may still be holding the counter's lock, so the counter isn't safe to destroy until it lets go
+	std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::runParallelFor(int count, int grainSize, const std::function<void(int, int)>& function)
+{
+	if (count <= 0) return;
+	grainSize = std::max(1, grainSize);
+
+	// Not worth splitting, or nobody to split it with
+	if (count <= grainSize || m_workers.size() == 1)
+	{
+		function(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	for (int begin = 0; begin < count; begin += grainSize)
+	{
+		int end = std::min(count, begin + grainSize);
+		submit([&function, begin, end]() { function(begin, end); }, &counter);
+	}
+
+	wait(counter);
+}
+
+void JobSystem::sampleStats()
+{
+	Clock::time_point now = Clock::now();
+	double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastSample).count());
+	m_lastSample = now;
+
+	for (std::size_t i = 0; i < m_workers.size(); ++i)
+	{
+		Worker& worker = *m_workers[i];
+
+		long long busy = worker.busyNanoseconds.load(std::memory_order_relaxed);
+		int jobs = worker.jobCount.load(std::memory_order_relaxed);
+		int steals = worker.stealCount.load(std::memory_order_relaxed);
+
+		m_stats[i].utilisation = elapsed > 0.0 ? static_cast<float>(std::min(1.0, (busy - worker.sampledBusy) / elapsed)) : 0.f;
+		m_stats[i].jobCount = jobs - worker.sampledJobs;
+		m_stats[i].stealCount = steals - worker.sampledSteals;
+
+		worker.sampledBusy = busy;
+		worker.sampledJobs = jobs;
+		worker.sampledSteals = steals;
+	}
+}
+
+// Queues on the calling worker's own queue - threads outside the system use worker 0's
+void JobSystem::push(Job job)
+{
+	int workerIndex = (t_jobSystem == this) ? t_workerIndex : 0;
+	Worker& worker = *m_workers[workerIndex];
+
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+
+		// Drops the stolen jobs rather than growing past them
+		if (worker.front > 0 && worker.queue.size() == worker.queue.capacity())
+		{
+			worker.queue.erase(worker.queue.begin(), worker.queue.begin() + worker.front);
+			worker.front = 0;
+		}
+
+		worker.queue.push_back(std::move(job));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex); // Held so a worker can't miss the wake between checking and sleeping
+		m_queuedJobs.fetch_add(1, std::memory_order_relaxed);
+	}
+	m_wake.notify_one();
+}
+
+bool JobSystem::tryRunJob(int workerIndex)
+{
+	Job job;
+	bool found = false;
+	bool stolen = false;
+
+	// Newest first from its own queue, as its data is most likely still in the cache
+	{
+		Worker& own = *m_workers[workerIndex];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (own.hasJobs())
+		{
+			job = std::move(own.queue.back());
+			own.queue.pop_back();
+			found = true;
+
+			if (!own.hasJobs())
+			{
+				own.queue.clear();
+				own.front = 0;
+			}
+		}
+	}
+
+	// Otherwise the oldest job from another worker, starting from the next one along so the stealing is spread out
+	for (std::size_t offset = 1; !found && offset < m_workers.size(); ++offset)
+	{
+		Worker& victim = *m_workers[(workerIndex + offset) % m_workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (victim.hasJobs())
+		{
+			job = std::move(victim.queue[victim.front++]);
+			found = stolen = true;
+
+			if (!victim.hasJobs())
+			{
+				victim.queue.clear();
+				victim.front = 0;
+			}
+		}
+	}
+
+	if (!found) return false;
+
+	m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+	Clock::time_point start = Clock::now();
+	job.function();
+	long long duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	Worker& worker = *m_workers[workerIndex];
+	worker.busyNanoseconds.fetch_add(duration, std::memory_order_relaxed);
+	worker.jobCount.fetch_add(1, std::memory_order_relaxed);
+	if (stolen)
+		worker.stealCount.fetch_add(1, std::memory_order_relaxed);
+
+	finish(job.counter);
+	return true;
+}
+
+// Counts a job as done, queuing anything that was waiting on the counter once it reaches zero
+void JobSystem::finish(JobCounter* counter)
+{
+	if (!counter) return;
+
+	std::vector<std::function<void()>> continuations;
+	std::vector<JobCounter*> continuationCounters;
+	{
+		std::lock_guard<std::mutex> lock(counter->m_mutex);
+		if (counter->m_count.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+		continuations.swap(counter->m_continuations);
+		continuationCounters.swap(counter->m_continuationCounters);
+	}
+	// The counter may be destroyed by its waiter from here on, so only the moved out continuations are used
+
+	for (std::size_t i = 0; i < continuations.size(); ++i)
+		push({ std::move(continuations[i]), continuationCounters[i] });
+}
+
+void JobSystem::workerLoop(int workerIndex)
+{
+	t_jobSystem = this;
+	t_workerIndex = workerIndex;
+
+	while (m_running)
+	{
+		if (tryRunJob(workerIndex)) continue;
+
+		// Sleeps until a job is queued anywhere
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wake.wait(lock, [this]() { return !m_running || m_queuedJobs.load(std::memory_order_relaxed) > 0; });
+	}
+}
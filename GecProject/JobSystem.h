@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Counts the jobs submitted against it that haven't finished yet
+// Jobs can be queued to run once it reaches zero, which is how one job depends on others
+class JobCounter
+{
+public:
+	bool isDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+private:
+	friend class JobSystem;
+
+	std::atomic<int> m_count{ 0 };
+
+	std::mutex m_mutex; // Guards the continuations, so one can't be added just as the count reaches zero
+	std::vector<std::function<void()>> m_continuations;
+	std::vector<JobCounter*> m_continuationCounters; // What each continuation counts against, may be null
+};
+
+// How busy a worker has been, sampled once a second for the GUI
+struct WorkerStats
+{
+	float utilisation{ 0.f }; // Fraction of the last sample spent running jobs
+	int jobCount{ 0 }; // Jobs run during the last sample
+	int stealCount{ 0 }; // How many of those were taken from another worker's queue
+};
+
+// Work-stealing job scheduler
+// Each worker has its own queue - it takes work from the back of its own, and when that is empty steals from the front of another's
+// The thread that creates the system is worker 0, it has no thread of its own and runs jobs whenever it waits on them
+class JobSystem
+{
+public:
+	explicit JobSystem(int workerCount = 0); // 0 uses one worker per hardware thread
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Queues a job on the calling worker's queue, counting it against the counter if there is one
+	void submit(std::function<void()> job, JobCounter* counter = nullptr);
+
+	// Queues a job to run once the dependency reaches zero - straight away if it already has
+	void submitAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+	// Runs other jobs until the counter reaches zero, so waiting never leaves a core idle
+	void wait(JobCounter& counter);
+
+	// Calls function(begin, end) over [0, count) in chunks of at most grainSize, and waits for them all
+	// Each index is visited exactly once whichever worker runs it, so results match a plain loop as long as each index only writes its own data
+	template <typename Function>
+	void parallelFor(int count, int grainSize, Function&& function)
+	{
+		// Passed on by reference, which std::function holds without allocating - a lambda with several captures may not fit in its small buffer
+		runParallelFor(count, grainSize, std::ref(function));
+	}
+
+	int getWorkerCount() const { return static_cast<int>(m_workers.size()); }
+
+	void sampleStats(); // Works out each worker's utilisation since the last sample, called once a second by the GUI
+	const std::vector<WorkerStats>& getStats() const { return m_stats; }
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Job
+	{
+		std::function<void()> function;
+		JobCounter* counter{ nullptr };
+	};
+
+	// A worker's queue and its running totals, read by sampleStats
+	// The queue is a vector with a moving front rather than a deque, so once it has grown queuing and stealing never allocate
+	struct Worker
+	{
+		std::mutex mutex;
+		std::vector<Job> queue;
+		std::size_t front{ 0 }; // Jobs before the front have been stolen, the queue is emptied whenever it reaches the back
+
+		bool hasJobs() const { return front < queue.size(); }
+
+		std::atomic<long long> busyNanoseconds{ 0 };
+		std::atomic<int> jobCount{ 0 };
+		std::atomic<int> stealCount{ 0 };
+
+		long long sampledBusy{ 0 };
+		int sampledJobs{ 0 };
+		int sampledSteals{ 0 };
+	};
+
+	void runParallelFor(int count, int grainSize, const std::function<void(int, int)>& function);
+
+	void push(Job job);
+	bool tryRunJob(int workerIndex); // Runs one job from the worker's own queue, or one stolen from another, returns whether there was one
+	void finish(JobCounter* counter);
+	void workerLoop(int workerIndex);
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threads;
+
+	std::atomic<bool> m_running{ true };
+	std::atomic<int> m_queuedJobs{ 0 }; // Jobs waiting in any queue, so idle workers know when to wake
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+
+	std::vector<WorkerStats> m_stats;
+	Clock::time_point m_lastSample;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include "DynamicEntity.h"
+#include <cmath>
+#include <vector>
+
+// A kinematic body that travels back and forth along a path of waypoints - elevators and moving floors
+// It is integrated like any other body but never resolved, nothing pushes it, and the simulation carries whatever is standing on it
+class MovingPlatform : public DynamicEntity
+{
+public:
+	// The waypoints are the positions of the platform's centre, in the order they are visited
+	MovingPlatform(PhysicsStore& store, const StaticSprite& sprite, std::vector<sf::Vector2f> path, float speed)
+		: DynamicEntity(store, sprite, EntityType::Platform), m_path(std::move(path)), m_speed(speed)
+	{
+		this->setGravity(0.f);
+		m_store->setFlag(m_bodyIndex, BodyFlags::Kinematic, true);
+
+		if (!m_path.empty())
+		{
+			this->setPosition(m_path.front());
+			this->setPreviousPosition(m_path.front());
+		}
+	}
+
+	// Sets the velocity that takes the platform towards its next waypoint this tick, turning back at either end of the path
+	// The last step is shortened to land exactly on the waypoint, so the platform never drifts off its path
+	void update(float deltaTime) override
+	{
+		if (m_path.size() > 1)
+		{
+			sf::Vector2f toTarget = m_path[m_target] - getPosition();
+			float distance = std::hypot(toTarget.x, toTarget.y);
+			float step = m_speed * deltaTime;
+
+			if (distance <= step)
+			{
+				this->setVelocity(toTarget / deltaTime);
+				advanceTarget();
+			}
+			else
+			{
+				this->setVelocity(toTarget * (m_speed / distance));
+			}
+		}
+
+		DynamicEntity::update(deltaTime);
+	}
+private:
+	// Moves on to the next waypoint, reversing at the ends of the path
+	void advanceTarget()
+	{
+		int last = static_cast<int>(m_path.size()) - 1;
+
+		if ((m_target == last && m_direction > 0) || (m_target == 0 && m_direction < 0))
+			m_direction = -m_direction;
+
+		m_target += m_direction;
+	}
+
+	std::vector<sf::Vector2f> m_path;
+	float m_speed{ 30.f }; // Pixels per second along the path
+	int m_target{ 1 }; // The waypoint being travelled towards
+	int m_direction{ 1 }; // 1 heading towards the end of the path, -1 heading back
+};
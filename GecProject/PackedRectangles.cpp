@@ -0,0 +1,112 @@
+#include "PackedRectangles.h"
+#include "Simd.h"
+#include <bit>
+#include <limits>
+
+void PackedRectangles::clear()
+{
+	m_minX.clear();
+	m_minY.clear();
+	m_maxX.clear();
+	m_maxY.clear();
+	m_count = 0;
+}
+
+void PackedRectangles::add(const CollisionRectangle& rect)
+{
+	// Grows by a full set of lanes at a time, filled with inside out rectangles that fail every comparison
+	if (m_count == m_minX.size())
+	{
+		const float infinity = std::numeric_limits<float>::infinity();
+
+		m_minX.resize(m_count + LaneCount, infinity);
+		m_minY.resize(m_count + LaneCount, infinity);
+		m_maxX.resize(m_count + LaneCount, -infinity);
+		m_maxY.resize(m_count + LaneCount, -infinity);
+	}
+
+	m_minX[m_count] = rect.m_xPos;
+	m_minY[m_count] = rect.m_yPos;
+	m_maxX[m_count] = rect.m_xPos + rect.m_width;
+	m_maxY[m_count] = rect.m_yPos + rect.m_height;
+	m_count++;
+}
+
+// Appends the index of every rectangle overlapping the given one to hits, returns how many there were
+int PackedRectangles::intersectAll(const CollisionRectangle& rect, std::vector<int>& hits) const
+{
+#if defined(GEC_SIMD_AVX)
+	std::size_t firstHit = hits.size();
+
+	__m256 minX = _mm256_set1_ps(rect.m_xPos);
+	__m256 minY = _mm256_set1_ps(rect.m_yPos);
+	__m256 maxX = _mm256_set1_ps(rect.m_xPos + rect.m_width);
+	__m256 maxY = _mm256_set1_ps(rect.m_yPos + rect.m_height);
+
+	// Eight rectangles per loop, the padding means there is never a partial set
+	for (std::size_t i = 0; i < m_count; i += 8)
+	{
+		__m256 overlapX = _mm256_and_ps(_mm256_cmp_ps(maxX, _mm256_loadu_ps(&m_minX[i]), _CMP_GE_OQ), _mm256_cmp_ps(minX, _mm256_loadu_ps(&m_maxX[i]), _CMP_LE_OQ));
+		__m256 overlapY = _mm256_and_ps(_mm256_cmp_ps(maxY, _mm256_loadu_ps(&m_minY[i]), _CMP_GE_OQ), _mm256_cmp_ps(minY, _mm256_loadu_ps(&m_maxY[i]), _CMP_LE_OQ));
+
+		// One bit per lane that overlaps on both axes
+		for (unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_and_ps(overlapX, overlapY))); mask != 0; mask &= mask - 1)
+			hits.push_back(static_cast<int>(i) + std::countr_zero(mask));
+	}
+
+	return static_cast<int>(hits.size() - firstHit);
+#elif defined(GEC_SIMD_SSE2)
+	std::size_t firstHit = hits.size();
+
+	__m128 minX = _mm_set1_ps(rect.m_xPos);
+	__m128 minY = _mm_set1_ps(rect.m_yPos);
+	__m128 maxX = _mm_set1_ps(rect.m_xPos + rect.m_width);
+	__m128 maxY = _mm_set1_ps(rect.m_yPos + rect.m_height);
+
+	// Four rectangles per loop, the padding means there is never a partial set
+	for (std::size_t i = 0; i < m_count; i += 4)
+	{
+		__m128 overlapX = _mm_and_ps(_mm_cmpge_ps(maxX, _mm_loadu_ps(&m_minX[i])), _mm_cmple_ps(minX, _mm_loadu_ps(&m_maxX[i])));
+		__m128 overlapY = _mm_and_ps(_mm_cmpge_ps(maxY, _mm_loadu_ps(&m_minY[i])), _mm_cmple_ps(minY, _mm_loadu_ps(&m_maxY[i])));
+
+		// One bit per lane that overlaps on both axes
+		for (unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_and_ps(overlapX, overlapY))); mask != 0; mask &= mask - 1)
+			hits.push_back(static_cast<int>(i) + std::countr_zero(mask));
+	}
+
+	return static_cast<int>(hits.size() - firstHit);
+#else
+	return intersectAllScalar(rect, hits);
+#endif
+}
+
+// The same test without SIMD, for comparison
+int PackedRectangles::intersectAllScalar(const CollisionRectangle& rect, std::vector<int>& hits) const
+{
+	std::size_t firstHit = hits.size();
+
+	float minX = rect.m_xPos;
+	float minY = rect.m_yPos;
+	float maxX = rect.m_xPos + rect.m_width;
+	float maxY = rect.m_yPos + rect.m_height;
+
+	for (std::size_t i = 0; i < m_count; ++i)
+	{
+		if (maxX >= m_minX[i] && minX <= m_maxX[i] && maxY >= m_minY[i] && minY <= m_maxY[i])
+			hits.push_back(static_cast<int>(i));
+	}
+
+	return static_cast<int>(hits.size() - firstHit);
+}
+
+// Which instruction set intersectAll was built with
+const char* PackedRectangles::getKernelName()
+{
+#if defined(GEC_SIMD_AVX)
+	return "AVX";
+#elif defined(GEC_SIMD_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
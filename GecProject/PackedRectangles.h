@@ -0,0 +1,32 @@
+#pragma once
+#include "CollisionRectangle.h"
+#include <cstddef>
+#include <vector>
+
+// A list of rectangles stored as separate arrays of edges, so one rectangle can be tested against many at once with SIMD
+// Uses AVX when the build enables it, SSE2 on any other x86/x64 build, and a scalar loop everywhere else
+class PackedRectangles
+{
+public:
+	void clear();
+	void add(const CollisionRectangle& rect);
+
+	std::size_t size() const { return m_count; }
+
+	// Appends the index of every rectangle overlapping the given one to hits, returns how many there were
+	// Touching edges count as overlapping, matching CollisionRectangle::intersection
+	int intersectAll(const CollisionRectangle& rect, std::vector<int>& hits) const;
+	int intersectAllScalar(const CollisionRectangle& rect, std::vector<int>& hits) const; // The same test without SIMD, for comparison
+
+	static const char* getKernelName(); // Which instruction set intersectAll was built with
+private:
+	static constexpr std::size_t LaneCount = 8; // The arrays are padded to a multiple of the widest SIMD width
+
+	// Edges of each rectangle, padding lanes are set up so they never overlap anything
+	std::vector<float> m_minX;
+	std::vector<float> m_minY;
+	std::vector<float> m_maxX;
+	std::vector<float> m_maxY;
+
+	std::size_t m_count{ 0 }; // How many real rectangles there are
+};
@@ -0,0 +1,149 @@
+#include "PhysicsStore.h"
+#include "DynamicEntity.h"
+#include "Simd.h"
+
+// Adds a body at the origin, returns its index
+int PhysicsStore::add(DynamicEntity* owner, float width, float height, float gravity)
+{
+	m_x.push_back(0.f);
+	m_y.push_back(0.f);
+	m_startX.push_back(0.f);
+	m_startY.push_back(0.f);
+	m_velocityX.push_back(0.f);
+	m_velocityY.push_back(0.f);
+	m_gravity.push_back(gravity);
+	m_width.push_back(width);
+	m_height.push_back(height);
+	m_flags.push_back(BodyFlags::None);
+	m_timeScale.push_back(1.f);
+	m_restTicks.push_back(0);
+	m_owners.push_back(owner);
+
+	return static_cast<int>(m_owners.size()) - 1;
+}
+
+// Swaps the last body into the index and pops, so the arrays stay contiguous without shifting every body after it
+void PhysicsStore::remove(int index)
+{
+	int last = static_cast<int>(m_owners.size()) - 1;
+
+	if (index != last)
+	{
+		m_x[index] = m_x[last];
+		m_y[index] = m_y[last];
+		m_startX[index] = m_startX[last];
+		m_startY[index] = m_startY[last];
+		m_velocityX[index] = m_velocityX[last];
+		m_velocityY[index] = m_velocityY[last];
+		m_gravity[index] = m_gravity[last];
+		m_width[index] = m_width[last];
+		m_height[index] = m_height[last];
+		m_flags[index] = m_flags[last];
+		m_timeScale[index] = m_timeScale[last];
+		m_restTicks[index] = m_restTicks[last];
+		m_owners[index] = m_owners[last];
+
+		m_owners[index]->setBodyIndex(index); // The moved body's owner has to know where it now lives
+	}
+
+	m_x.pop_back();
+	m_y.pop_back();
+	m_startX.pop_back();
+	m_startY.pop_back();
+	m_velocityX.pop_back();
+	m_velocityY.pop_back();
+	m_gravity.pop_back();
+	m_width.pop_back();
+	m_height.pop_back();
+	m_flags.pop_back();
+	m_timeScale.pop_back();
+	m_restTicks.pop_back();
+	m_owners.pop_back();
+}
+
+// Counts the ticks a resolved body has spent grounded and still, putting it to sleep once it reaches the limit
+void PhysicsStore::updateRest(int index, int sleepAfterTicks)
+{
+	bool resting = hasFlag(index, BodyFlags::Grounded) && m_velocityX[index] == 0.f && m_velocityY[index] == 0.f;
+
+	if (!resting)
+		m_restTicks[index] = 0;
+	else if (++m_restTicks[index] >= sleepAfterTicks)
+		sleep(index);
+}
+
+// Applies gravity and moves every body by its velocity in one SIMD loop, remembering where each started so the move can be resolved afterwards
+// Sleeping bodies go through the same loop with a zero timestep, which is cheaper than branching around them
+void PhysicsStore::integrate(float deltaTime)
+{
+	std::size_t count = m_owners.size();
+	std::size_t i = 0;
+
+	float* x = m_x.data();
+	float* y = m_y.data();
+	float* startX = m_startX.data();
+	float* startY = m_startY.data();
+	float* velocityX = m_velocityX.data();
+	float* velocityY = m_velocityY.data();
+	const float* gravity = m_gravity.data();
+	const float* timeScale = m_timeScale.data();
+
+#if defined(GEC_SIMD_AVX)
+	__m256 timestep = _mm256_set1_ps(deltaTime);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 step = _mm256_mul_ps(timestep, _mm256_loadu_ps(timeScale + i)); // Zero for sleeping bodies
+
+		__m256 positionX = _mm256_loadu_ps(x + i);
+		__m256 positionY = _mm256_loadu_ps(y + i);
+		_mm256_storeu_ps(startX + i, positionX);
+		_mm256_storeu_ps(startY + i, positionY);
+
+		__m256 fallVelocity = _mm256_add_ps(_mm256_loadu_ps(velocityY + i), _mm256_mul_ps(_mm256_loadu_ps(gravity + i), step));
+		_mm256_storeu_ps(velocityY + i, fallVelocity);
+
+		_mm256_storeu_ps(x + i, _mm256_add_ps(positionX, _mm256_mul_ps(_mm256_loadu_ps(velocityX + i), step)));
+		_mm256_storeu_ps(y + i, _mm256_add_ps(positionY, _mm256_mul_ps(fallVelocity, step)));
+	}
+#elif defined(GEC_SIMD_SSE2)
+	__m128 timestep = _mm_set1_ps(deltaTime);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 step = _mm_mul_ps(timestep, _mm_loadu_ps(timeScale + i)); // Zero for sleeping bodies
+
+		__m128 positionX = _mm_loadu_ps(x + i);
+		__m128 positionY = _mm_loadu_ps(y + i);
+		_mm_storeu_ps(startX + i, positionX);
+		_mm_storeu_ps(startY + i, positionY);
+
+		__m128 fallVelocity = _mm_add_ps(_mm_loadu_ps(velocityY + i), _mm_mul_ps(_mm_loadu_ps(gravity + i), step));
+		_mm_storeu_ps(velocityY + i, fallVelocity);
+
+		_mm_storeu_ps(x + i, _mm_add_ps(positionX, _mm_mul_ps(_mm_loadu_ps(velocityX + i), step)));
+		_mm_storeu_ps(y + i, _mm_add_ps(positionY, _mm_mul_ps(fallVelocity, step)));
+	}
+#endif
+
+	// Whatever is left over, or every body without SIMD - the same maths, so results match the SIMD lanes exactly
+	for (; i < count; ++i)
+	{
+		startX[i] = x[i];
+		startY[i] = y[i];
+
+		float step = deltaTime * timeScale[i];
+
+		velocityY[i] += gravity[i] * step;
+
+		x[i] += velocityX[i] * step;
+		y[i] += velocityY[i] * step;
+	}
+}
+
+// Writes every body's position back to its entity's sprite and hitbox, in one pass after the physics has run
+void PhysicsStore::scatter()
+{
+	for (std::size_t i = 0; i < m_owners.size(); ++i)
+		m_owners[i]->syncFromStore(m_x[i], m_y[i]);
+}
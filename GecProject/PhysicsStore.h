@@ -0,0 +1,97 @@
+#pragma once
+#include "CollisionRectangle.h"
+#include <cstdint>
+#include <vector>
+
+class DynamicEntity;
+
+// Per-body state flags, stored packed in PhysicsStore::m_flags
+namespace BodyFlags
+{
+	constexpr std::uint8_t None = 0;
+	constexpr std::uint8_t Grounded = 1 << 0; // Resting on something solid
+	constexpr std::uint8_t Continuous = 1 << 1; // Swept separately rather than by the axis-separated resolver - bullets
+	constexpr std::uint8_t Sleeping = 1 << 2; // Has rested long enough to be left out of integration and collision until woken
+	constexpr std::uint8_t Frozen = 1 << 3; // Outside the simulation's activation region, left exactly as it is until it is back inside
+	constexpr std::uint8_t Kinematic = 1 << 4; // Moved only by its velocity, never resolved or pushed - moving platforms
+}
+
+// Contiguous structure-of-arrays storage for the physics state of every dynamic entity
+// The integration and collision passes stream through these arrays linearly, rather than hopping between heap allocated entities
+// Positions are the centre of the body, matching the entity's sprite origin
+class PhysicsStore
+{
+public:
+	int add(DynamicEntity* owner, float width, float height, float gravity); // Adds a body at the origin, returns its index
+	void remove(int index); // Swaps the last body into the index and pops, updating the moved body's owner
+
+	std::size_t size() const { return m_owners.size(); }
+
+	// The body's hitbox, built from its centre and size
+	CollisionRectangle getHitbox(int index) const
+	{
+		return CollisionRectangle(m_x[index] - m_width[index] / 2.f, m_y[index] - m_height[index] / 2.f, m_height[index], m_width[index]);
+	}
+
+	// The body's hitbox where it was before the last integrate
+	CollisionRectangle getStartHitbox(int index) const
+	{
+		return CollisionRectangle(m_startX[index] - m_width[index] / 2.f, m_startY[index] - m_height[index] / 2.f, m_height[index], m_width[index]);
+	}
+
+	bool hasFlag(int index, std::uint8_t flag) const { return (m_flags[index] & flag) != 0; }
+	void setFlag(int index, std::uint8_t flag, bool enabled)
+	{
+		if (enabled)
+			m_flags[index] |= flag;
+		else
+			m_flags[index] &= ~flag;
+	}
+
+	// Sleeping bodies keep their grounded state but aren't integrated or resolved, until something wakes them
+	bool isSleeping(int index) const { return hasFlag(index, BodyFlags::Sleeping); }
+	void sleep(int index)
+	{
+		setFlag(index, BodyFlags::Sleeping, true);
+		updateTimeScale(index);
+	}
+	void wake(int index)
+	{
+		setFlag(index, BodyFlags::Sleeping, false);
+		updateTimeScale(index);
+		m_restTicks[index] = 0;
+	}
+
+	// Frozen bodies are skipped like sleeping ones, but keep their velocity and aren't woken by contact
+	bool isFrozen(int index) const { return hasFlag(index, BodyFlags::Frozen); }
+	void setFrozen(int index, bool frozen)
+	{
+		setFlag(index, BodyFlags::Frozen, frozen);
+		updateTimeScale(index);
+	}
+
+	// Counts the ticks a resolved body has spent grounded and still, putting it to sleep once it reaches the limit
+	void updateRest(int index, int sleepAfterTicks);
+
+	// Applies gravity and moves every body by its velocity in one SIMD loop, remembering where each started so the move can be resolved afterwards
+	void integrate(float deltaTime);
+
+	// Writes every body's position back to its entity's sprite and hitbox, in one pass after the physics has run
+	void scatter();
+
+	std::vector<float> m_x;
+	std::vector<float> m_y;
+	std::vector<float> m_startX; // Position before the last integrate
+	std::vector<float> m_startY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_gravity; // Per body, so bodies without gravity (bullets) don't need their own update
+	std::vector<float> m_width;
+	std::vector<float> m_height;
+	std::vector<std::uint8_t> m_flags;
+	std::vector<float> m_timeScale; // 1 while awake and 0 while sleeping or frozen - scales the timestep, so the batched integrate leaves sleeping bodies where they are
+	std::vector<int> m_restTicks; // Consecutive ticks spent grounded and still
+	std::vector<DynamicEntity*> m_owners; // The entity each body belongs to
+private:
+	void updateTimeScale(int index) { m_timeScale[index] = hasFlag(index, BodyFlags::Sleeping | BodyFlags::Frozen) ? 0.f : 1.f; }
+};
@@ -1,7 +1,7 @@
 #include "PlayerEntity.h"
 
-PlayerEntity::PlayerEntity(const AnimationManager& animManager) 
-	: DynamicEntity(animManager.getAnimation("playerIdle"), EntityType::Player)
+PlayerEntity::PlayerEntity(PhysicsStore& store, const AnimationManager& animManager) 
+	: DynamicEntity(store, animManager.getAnimation("playerIdle"), EntityType::Player)
 {
 	m_playerIdle = &animManager.getAnimation("playerIdle");
 	m_playerJump = &animManager.getAnimation("playerJump");
@@ -13,25 +13,21 @@ PlayerEntity::PlayerEntity(const AnimationManager& animManager)
 
 void PlayerEntity::update(float deltaTime)
 {
-	// Shoot Cooldown Timer
-	if (m_shootCooldownTimer > 0.f)
-		m_shootCooldownTimer -= deltaTime;
-
 	// Sprite Flipper
-	if (m_velocity.x < 0)
+	if (getVelocity().x < 0)
 		this->flipSprite(true);
-	else if (m_velocity.x > 0)
+	else if (getVelocity().x > 0)
 		this->flipSprite(false);
 
 	// Animation Setter
 	// Checks whether the player is shooting, to decide which set of animations to use
-	if (m_shootCooldownTimer > 0.f)
+	if (isCoolingDown(m_shootCooldownTimer))
 	{
 		// Checks whether the player is on the ground or in the air
-		if (m_grounded)
+		if (isGrounded())
 		{
 			// Checks whether the player is moving or standing still
-			if (m_velocity.x != 0)
+			if (getVelocity().x != 0)
 			{
 				if (m_animation != m_playerWalkShot)
 					this->setAnimation(*m_playerWalkShot);
@@ -51,10 +47,10 @@ void PlayerEntity::update(float deltaTime)
 	else // Not shooting
 	{
 		// Checks whether the player is on the ground or in the air
-		if (m_grounded)
+		if (isGrounded())
 		{
 			// Checks whether the player is moving or standing still
-			if (m_velocity.x != 0)
+			if (getVelocity().x != 0)
 			{
 				if (m_animation != m_playerWalk)
 					this->setAnimation(*m_playerWalk);
@@ -78,7 +74,7 @@ void PlayerEntity::update(float deltaTime)
 // Handles player input based on the provided actions
 void PlayerEntity::handleInput(const std::vector<Actions>& actions)
 {
-	m_velocity.x = 0.f; // Resets the velocity to zero each frame, so the player stops moving when no keys are pressed
+	setVelocityX(0.f); // Resets the velocity to zero each frame, so the player stops moving when no keys are pressed
 	bool isJumping{ false }; // Whether the player is currently jumping, for the variable jump-height
 
 	// Resets the looking up/down states each frame
@@ -93,10 +89,10 @@ void PlayerEntity::handleInput(const std::vector<Actions>& actions)
 		switch (action)
 		{
 		case Actions::eMoveRight:
-			m_velocity.x = m_speed; // Moves right by setting a positive x velocity
+			setVelocityX(m_speed); // Moves right by setting a positive x velocity
 			break;
 		case Actions::eMoveLeft:
-			m_velocity.x = -m_speed; // Moves left by setting a negative x velocity
+			setVelocityX(-m_speed); // Moves left by setting a negative x velocity
 			break;
 		case Actions::eJump:
 			isJumping = true; // Sets the jumping flag to true
@@ -118,15 +114,15 @@ void PlayerEntity::handleInput(const std::vector<Actions>& actions)
 	m_wantsToShoot = isShootKeyDown; // Updates the wantsToShoot flag based on whether the shoot key is down
 
 	// Prevents the player from holding the jump key, to keep jumping
-	if (m_grounded && isJumping && !m_wasJumping)
+	if (isGrounded() && isJumping && !m_wasJumping)
 	{
-		m_velocity.y = m_jumpHeight; // Sets a negative y velocity to make the player jump
-		m_grounded = false;
+		setVelocityY(m_jumpHeight); // Sets a negative y velocity to make the player jump
+		setIsGrounded(false);
 	}
 
 	// Variable jump height: if the player releases the jump key while going up, reduces the y velocity
-	if (m_velocity.y < 0 && !isJumping)
-		m_velocity.y *= 0.5f;
+	if (getVelocity().y < 0 && !isJumping)
+		setVelocityY(getVelocity().y * 0.5f);
 
 	m_wasJumping = isJumping; // Updates the wasJumping flag for the next frame
 }
@@ -135,9 +131,9 @@ void PlayerEntity::handleInput(const std::vector<Actions>& actions)
 bool PlayerEntity::tryShoot(sf::Vector2f& direction, bool& facingRight)
 {
 	// Checks whether the player wants to shoot and if the cooldown timer has elapsed
-	if (m_wantsToShoot && m_shootCooldownTimer <= 0.f)
+	if (m_wantsToShoot && !isCoolingDown(m_shootCooldownTimer))
 	{
-		m_shootCooldownTimer = m_shootCooldown; // Sets a cooldown of 0.5 seconds between shots
+		startCooldown(m_shootCooldownTimer, m_shootCooldown); // Sets a cooldown of 0.5 seconds between shots
 		m_wantsToShoot = false; // Resets the wantsToShoot flag
 
 		float xDir = isFacingRight() ? 1.f : -1.f;
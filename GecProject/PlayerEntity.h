@@ -4,7 +4,7 @@
 class PlayerEntity : public DynamicEntity, public IReceivesInput
 {
 public:
-	explicit PlayerEntity(const AnimationManager& animManager); // Uses the base class constructor
+	PlayerEntity(PhysicsStore& store, const AnimationManager& animManager); // Uses the base class constructor
 
 	void update(float deltaTime) override;
 	void handleInput(const std::vector<Actions>& actions); // Implements the input handling from IReceivesInput
@@ -37,6 +37,6 @@ private:
 	bool m_isLookingDown{ false };
 	bool m_wantsToShoot{ false };
 
-	float m_shootCooldownTimer{ 0.f };
+	TimerHandle m_shootCooldownTimer;
 	float m_shootCooldown{ 0.5f }; // Time between being able to shoot again
 };
\ No newline at end of file
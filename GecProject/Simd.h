@@ -0,0 +1,11 @@
+#pragma once
+
+// Picks the widest SIMD instruction set the build enables, for the batched physics kernels
+// AVX needs to be enabled by the build (/arch:AVX or -mavx), SSE2 is always there on x64. Anything else falls back to scalar loops
+#if defined(__AVX__)
+#define GEC_SIMD_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEC_SIMD_SSE2
+#include <emmintrin.h>
+#endif
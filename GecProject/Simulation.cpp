@@ -1,14 +1,59 @@
 #include "Simulation.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
 
-Simulation::Simulation(TextureManager& textureManager) :
+Simulation::Simulation(TextureManager& textureManager, JobSystem& jobSystem) :
+    m_jobSystem(jobSystem),
     m_animationManager(textureManager)
 {
+    configureCollisionFilter();
+    configureTileProperties();
     reset();
 }
 
+// Sets up which collision layers test against which, done once as the rules never change
+void Simulation::configureCollisionFilter()
+{
+    namespace Layers = CollisionLayers;
+
+    m_collisionFilter.setTestsAgainst(Layers::Player, Layers::World | Layers::Platform | Layers::Enemy | Layers::Collectable | Layers::Door); // Enemies block the player
+    m_collisionFilter.setTestsAgainst(Layers::Enemy, Layers::World | Layers::Platform | Layers::Enemy); // But the player doesn't block enemies
+    m_collisionFilter.setTestsAgainst(Layers::PlayerBullet, Layers::World | Layers::Platform | Layers::Enemy | Layers::Door);
+    m_collisionFilter.setTestsAgainst(Layers::EnemyBullet, Layers::World | Layers::Platform | Layers::Player | Layers::Door);
+    m_collisionFilter.setTestsAgainst(Layers::Collectable, Layers::Player);
+    m_collisionFilter.setTestsAgainst(Layers::Door, Layers::Player);
+}
+
+// Sets how each tile in tilemap_packed.png collides, by level ID (the tile's index in the sheet plus one) - anything not listed is a plain solid
+void Simulation::configureTileProperties()
+{
+    TilePropertyTable properties;
+
+    // The orange girders can be jumped up through and landed on
+    for (int id : { 5, 6, 7, 21, 22, 23, 39 })
+        properties.set(id, TileFlags::OneWay);
+
+    // The two halves of the roof peak
+    properties.setSlope(67, 0.f, 1.f);
+    properties.setSlope(68, 1.f, 0.f);
+
+    // The yellow and black striped bars are solid, but hurt to touch
+    for (int id : { 88, 89, 90, 91, 104, 105, 106, 107 })
+        properties.set(id, TileFlags::Solid | TileFlags::Hazard);
+
+    // Ropes, chains, lights, signs and poles are only decoration
+    for (int id : { 8, 9, 24, 25, 40, 41, 56, 57, 72, 73, 65, 66, 43, 58, 74, 59, 75 })
+        properties.set(id, TileFlags::None);
+
+    m_tileLayer.setProperties(properties);
+}
+
 void Simulation::reset()
 {
-    m_player = nullptr;
+    m_players.clear(); // Leaves m_player, and every enemy's handle to the player, stale - so the next level creates a new one
+    m_entities.clear(); // Would otherwise still point at the old player
+    m_staticEntityCount = 0;
     m_score = 0;
     m_levelComplete = false;
 
@@ -16,7 +61,7 @@ void Simulation::reset()
 
     loadLevel("Data/Levels/Level1.txt");
 
-    if (!m_player)
+    if (!getPlayerEntity())
     {
         std::cout << "CRITICAL ERROR: Player not spawned!" << std::endl;
     }
@@ -24,40 +69,54 @@ void Simulation::reset()
 
 bool Simulation::isGameOver() const
 {
-    if (!m_player) return true;
-    return m_player->getHealth() <= 0;
+    if (!getPlayerEntity()) return true;
+    return getPlayerEntity()->getHealth() <= 0;
 }
 
 // Updates the input manager with new inputs, loops through all entities and updates them, and handles the hitboxes and collisions
 void Simulation::update(float deltaTime)
 {
 	// Store previous positions for interpolation - doneso before updating positions
-    if (m_player)
-        m_player->setPreviousPosition(m_player->getPosition());
+    if (getPlayerEntity())
+        getPlayerEntity()->setPreviousPosition(getPlayerEntity()->getPosition());
 
-    for (auto& entity : m_entities)
+    // Only the player, enemies, platforms and bullets move - everything else keeps the previous position it was created with
+    // Frozen enemies don't move either, so only the active ones need it
+    for (Enemy* enemy : m_activeEnemies)
     {
-        entity->setPreviousPosition(entity->getPosition());
+        enemy->setPreviousPosition(enemy->getPosition());
     }
 
+    for (auto& platform : m_platforms)
+        platform->setPreviousPosition(platform->getPosition());
+
     for (auto& bullet : m_bulletPool)
     {
         if (bullet->isActive())
             bullet->setPreviousPosition(bullet->getPosition());
     }
 
-	if (!m_player) return; // Safety check - incase player is null
+	if (!getPlayerEntity()) return; // Safety check - incase player is null
+
+    resetFrameArena(); // Last tick's contacts, trigger events and destroyed list aren't needed after this
+
+    if (m_broadphaseStatsEnabled)
+        m_broadphaseStats = BroadphaseStats{}; // Counts are per tick
 
     m_inputManager.update();
 
+    m_timers.advance(deltaTime); // Fires this tick's timers first - bullets expiring are gone before anything can hit them
+
+    updateActivation(); // Decides which enemies and collectables are simulated this tick
+
     sf::Vector2f shootDir;
     bool facingRight;
 
 	// Handle shooting
-    if (m_player->tryShoot(shootDir, facingRight))
+    if (getPlayerEntity()->tryShoot(shootDir, facingRight))
     {
         // Adjust to gun height to better match player sprite (the gun)
-        sf::Vector2f spawnPos = m_player->getPosition();
+        sf::Vector2f spawnPos = getPlayerEntity()->getPosition();
 
 		// Offset for the gun position
         float xOffset = 2.5f;
@@ -71,24 +130,12 @@ void Simulation::update(float deltaTime)
 
 		spawnPos.y += yOffset; // Adjust for gun height
 
-        // Find the first sleeping bullet and fire it
-        for (auto& bullet : m_bulletPool)
-        {
-            if (!bullet->isActive())
-            {
-				bullet->fire(spawnPos, shootDir * 250.f, false); // Multiplies direction by speed
-                break; // We fired one, stop looking
-            }
-        }
+        fireBullet(spawnPos, shootDir * 250.f, false); // Multiplies direction by speed
     }
 
 	// Enemy Shooting
-    for (auto& entity : m_entities)
+    for (Enemy* enemy : m_activeEnemies)
     {
-        // Check if this entity is an Enemy
-        Enemy* enemy = dynamic_cast<Enemy*>(entity.get());
-        if (!enemy) continue; // Skip non-enemies
-
 		sf::Vector2f shotDir; // Checks which direction to shoot in
 		// Attempt to shoot
         if (enemy->tryShoot(shotDir))
@@ -108,266 +155,799 @@ void Simulation::update(float deltaTime)
 
             spawnPos.y += yOffset; // Adjust for gun height
 
-            // Find a bullet to fire
-            for (auto& bullet : m_bulletPool)
-            {
-				// Only fire if the bullet is inactive
-                if (!bullet->isActive())
-                {
-                    bullet->fire(spawnPos, shotDir * 250.f, true);
-                    break;
-                }
-            }
+            fireBullet(spawnPos, shotDir * 250.f, true);
         }
     }
 
-    // Loops through all entities and updates them
-    for (auto& entity : m_entities)
+    // The tick runs in phases, each finishing before the next starts
+    updateBehaviour(deltaTime);
+
+    // Sleeping bodies near the player are woken, so anything it can reach responds straight away
+    CollisionRectangle playerHitbox = getPlayerEntity()->getHitbox();
+    wakeBodiesIn(CollisionRectangle(playerHitbox.m_xPos - WakeDistance, playerHitbox.m_yPos - WakeDistance, playerHitbox.m_height + WakeDistance * 2.f, playerHitbox.m_width + WakeDistance * 2.f), getPlayerEntity());
+
+    // Integration - gravity and velocity are applied to every body in one batched pass
+    m_physics.integrate(deltaTime);
+
+    resolveCollisions();
+    resolveGameplay();
+}
+
+// Drops every tick-scoped list before rewinding the arena, as the memory they hold is about to be handed out again
+void Simulation::resetFrameArena()
+{
+    m_contacts = std::pmr::vector<ContactEvent>(&m_frameArena);
+    m_destroyed = std::pmr::vector<Entity*>(&m_frameArena);
+    m_triggerEvents = std::pmr::vector<TriggerEvent>(&m_frameArena);
+    m_triggerEntities = std::pmr::vector<Entity*>(&m_frameArena);
+
+    m_frameArena.reset();
+}
+
+// The area around the camera that is simulated, everything outside it is frozen until it comes back in
+CollisionRectangle Simulation::getActivationArea() const
+{
+    // Covers the whole level, and anything that has fallen out of it, when the region is turned off
+    if (!m_activationEnabled)
+        return CollisionRectangle(-m_levelSize.x, -m_levelSize.y, m_levelSize.y * 3.f, m_levelSize.x * 3.f);
+
+    // Follows the camera when Graphics has given one, otherwise a default sized view on the player
+    sf::Vector2f centre = m_activationView.getCenter();
+    sf::Vector2f size = m_activationView.size;
+    if (size.x <= 0.f || size.y <= 0.f)
     {
-        entity->update(deltaTime);
+        centre = getPlayerEntity()->getPosition();
+        size = DefaultActivationSize;
+    }
 
-		DynamicEntity* dynamicEntity = dynamic_cast<DynamicEntity*>(entity.get());
+    return CollisionRectangle(centre.x - size.x / 2.f - m_activationMargin, centre.y - size.y / 2.f - m_activationMargin,
+        size.y + m_activationMargin * 2.f, size.x + m_activationMargin * 2.f);
+}
 
-		if (dynamicEntity == nullptr) continue; // Skips if not dynamic, as only dynamic entities need collision handling
+// Refills the active enemies and collectables from the broadphases, so the cost depends on what is near the camera rather than the level's length
+// Everything active last tick is frozen, then everything found is unfrozen - so enemies leaving are frozen and those entering are picked up in one pass
+void Simulation::updateActivation()
+{
+    CollisionRectangle area = getActivationArea();
 
-		// Edge Detection for Enemies
-        Enemy* enemy = dynamic_cast<Enemy*>(entity.get());
-		if (enemy && enemy->isGrounded() && std::abs(enemy->getSpeed()) > 0.1) // Only checks for enemies that are on the ground
+    for (Enemy* enemy : m_activeEnemies)
+        enemy->setFrozen(true);
+
+    m_activeEnemies.clear();
+    m_bodyTree.query(area, CollisionLayers::Enemy, [&](int proxyId)
         {
-            sf::Vector2f velocity = enemy->getVelocity();
-            CollisionRectangle enemyBox = enemy->getHitbox();
+            Enemy* enemy = static_cast<Enemy*>(m_bodyTree.getEntity(proxyId)); // Only enemies are on the enemy layer
+            if (area.intersection(m_physics.getHitbox(enemy->getBodyIndex())))
+                m_activeEnemies.push_back(enemy);
+            return true;
+        });
+
+    // The tree's order depends on its shape, so the list is sorted to keep the update, and the bullets the enemies fire, in a repeatable order
+    std::sort(m_activeEnemies.begin(), m_activeEnemies.end(), [](const Enemy* a, const Enemy* b) { return a->getBodyIndex() < b->getBodyIndex(); });
 
-            // Create a small "sensor" box
-            CollisionRectangle edgeSensor;
-			edgeSensor.m_width = 4.f;  // Small width to ensure it only checks directly in front
-			edgeSensor.m_height = 4.f; // Small height to just check below the feet
-            edgeSensor.m_yPos = enemyBox.m_yPos + enemyBox.m_height; // Positioned at the feet
+    for (Enemy* enemy : m_activeEnemies)
+    {
+        // Entering enemies haven't moved since they were frozen, so have nothing to interpolate from
+        if (enemy->isFrozen())
+            enemy->setPreviousPosition(enemy->getPosition());
+
+        enemy->setFrozen(false);
+    }
+
+    // Collectables don't move, so being left out of the list is all freezing them needs
+    m_activeCollectables.clear();
+    m_candidates.clear();
+    m_broadphase.query(area, CollisionLayers::Collectable, m_candidates);
+
+    for (Entity* candidate : m_candidates)
+    {
+        if (area.intersection(candidate->getHitbox()))
+            m_activeCollectables.push_back(static_cast<Collectable*>(candidate)); // Only collectables are on the collectable layer
+    }
+}
+
+// Behaviour - updates the entities' animations and states, dynamic entities only set their velocities in the physics store
+// Enemies and collectables only write to themselves and their own body, so they can be updated in any order, or all at once
+void Simulation::updateBehaviour(float deltaTime)
+{
+    // The player is updated first on its own, as the enemies read its position
+    getPlayerEntity()->update(deltaTime);
 
-            // Place sensor to the Left or Right depending on movement
-            if (velocity.x > 0) // Moving Right
-                edgeSensor.m_xPos = enemyBox.m_xPos + enemyBox.m_width;
-            else if (velocity.x < 0) // Moving Left
-                edgeSensor.m_xPos = enemyBox.m_xPos - edgeSensor.m_width;
+    // Platforms only set their velocity towards their next waypoint, they are moved by the integration like everything else
+    for (auto& platform : m_platforms)
+        platform->update(deltaTime);
 
-            bool groundFound = false;
+    std::atomic<int> edgeChecks{ 0 }; // Counted rather than added to the stats directly, as the enemies may be on different threads
 
-            // Check if the sensor touches ANY floor tile
-            for (const auto& floor : m_entities)
+    auto updateEnemies = [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
             {
-				// Ignores self-collision & non-floor tiles
-                if (floor->getType() != EntityType::Standard) continue;
+                m_activeEnemies[i]->update(deltaTime);
 
-				// Checks for intersection with the floor hitbox
-                if (edgeSensor.intersection(floor->getHitbox()))
-                {
-                    groundFound = true;
-					break; // No need to check further if ground is found
-                }
+                if (checkForEdge(*m_activeEnemies[i]))
+                    edgeChecks.fetch_add(1, std::memory_order_relaxed);
             }
+        };
+
+    // Collectables are the only static entities with an animation, tiles and doors never change
+    auto updateCollectables = [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+                m_activeCollectables[i]->update(deltaTime);
+        };
+
+    int enemyCount = static_cast<int>(m_activeEnemies.size());
+    int collectableCount = static_cast<int>(m_activeCollectables.size());
+
+    if (m_parallelUpdate)
+    {
+        // Enemies cast rays so are split finer than the collectables, which only step their animation
+        m_jobSystem.parallelFor(enemyCount, 8, updateEnemies);
+        m_jobSystem.parallelFor(collectableCount, 64, updateCollectables);
+    }
+    else
+    {
+        updateEnemies(0, enemyCount);
+        updateCollectables(0, collectableCount);
+    }
+
+    if (m_broadphaseStatsEnabled)
+    {
+        m_broadphaseStats.edgeSensorPairs += edgeChecks;
+        m_broadphaseStats.bruteForcePairs += edgeChecks * static_cast<int>(m_entities.size());
+    }
+}
+
+// Edge detection for enemies - turns a walking enemy around before it walks off the floor, returns whether a check was needed
+// Only reads the tile layer and writes to the enemy itself, so is safe to call for several enemies at once
+bool Simulation::checkForEdge(Enemy& enemy) const
+{
+    if (!enemy.isGrounded() || std::abs(enemy.getSpeed()) <= 0.1) return false; // Only checks for enemies that are on the ground
+
+    sf::Vector2f velocity = enemy.getVelocity();
+    CollisionRectangle enemyBox = enemy.getHitbox();
+    bool groundFound = true;
+
+    // Looks up the walkable span under the enemy's centre - the floor's extent was found at load, so this is a single grid lookup
+    const WalkableSpan* span = m_tileLayer.getWalkableSpan(enemyBox.m_xPos + enemyBox.m_width / 2.f, enemyBox.m_yPos + enemyBox.m_height);
+
+    if (span)
+    {
+        // Turns exactly as the leading edge passes an end of the span that drops off
+        if (velocity.x > 0) // Moving Right
+            groundFound = span->blockedRight || enemyBox.m_xPos + enemyBox.m_width <= span->right;
+        else if (velocity.x < 0) // Moving Left
+            groundFound = span->blockedLeft || enemyBox.m_xPos >= span->left;
+    }
+    else
+    {
+        // Not standing over a span (e.g. landed hanging over an edge), so falls back to a small "sensor" box
+        CollisionRectangle edgeSensor;
+        edgeSensor.m_width = 4.f;  // Small width to ensure it only checks directly in front
+        edgeSensor.m_height = 4.f; // Small height to just check below the feet
+        edgeSensor.m_yPos = enemyBox.m_yPos + enemyBox.m_height; // Positioned at the feet
+
+        // Place sensor to the Left or Right depending on movement
+        if (velocity.x > 0) // Moving Right
+            edgeSensor.m_xPos = enemyBox.m_xPos + enemyBox.m_width;
+        else if (velocity.x < 0) // Moving Left
+            edgeSensor.m_xPos = enemyBox.m_xPos - edgeSensor.m_width;
+
+        // Check if the sensor touches ANY floor tile - only the cells under the sensor are looked at
+        // An enemy riding a platform is never over a span, so the platforms are checked as well
+        groundFound = m_tileLayer.overlapsFloor(edgeSensor) || (!m_platforms.empty() && isOnPlatform(edgeSensor));
+    }
+
+	// If no ground found, turn around
+    if (!groundFound)
+        enemy.turnAround(); // Reverses direction
+
+    return true;
+}
+
+// Collision resolution - resolves the integrated moves against the level and each other, then sweeps the bullets
+void Simulation::resolveCollisions()
+{
+    // Collision resolution - streams through the physics store one body after another, bullets are swept separately below
+    // Sleeping and frozen bodies are skipped entirely, they were also left in place by the integration
+    m_awakeBodyCount = 0;
+    m_sleepingBodyCount = 0;
+    m_frozenBodyCount = 0;
+
+    movePlatforms(); // Platforms go first, so everything is resolved against where they are now
 
-			// If no ground found, turn around
-            if (!groundFound)
-                enemy->turnAround(); // Reverses direction
+    for (int body = 0; body < static_cast<int>(m_physics.size()); ++body)
+    {
+        if (m_physics.hasFlag(body, BodyFlags::Continuous | BodyFlags::Kinematic)) continue;
+
+        if (m_physics.isFrozen(body))
+        {
+            m_frozenBodyCount++;
+            continue;
+        }
+
+        if (m_physics.isSleeping(body))
+        {
+            m_sleepingBodyCount++;
+            continue;
         }
 
-		sf::Vector2f velocity = dynamicEntity->getVelocity();
+        resolveBody(body);
+        m_physics.updateRest(body, SleepAfterTicks);
+        m_awakeBodyCount++;
+    }
+
+    m_physics.scatter(); // Writes the resolved positions back to the sprites and hitboxes in one pass
+
+	// Bullet Collision - Is separate as bullets are not recognised as entities in the main entity vector
+	// Bullets are swept along their whole move rather than tested at the end of it, so they can't tunnel through thin tiles at low tick rates
+    for (auto& bullet : m_bulletPool)
+    {
+		if (!bullet->isActive()) continue; // Only checks active bullets
+
+        // The bullet has already been moved by the integrator, so its move this tick runs from its start position to where it is now
+        int body = bullet->getBodyIndex();
+        sf::Vector2f startPosition = { m_physics.m_startX[body], m_physics.m_startY[body] };
+        sf::Vector2f displacement = bullet->getPosition() - startPosition;
+
+        CollisionRectangle startHitbox = m_physics.getStartHitbox(body);
+        CollisionRectangle endHitbox = m_physics.getHitbox(body);
 
-        // X
-        dynamicEntity->move({ velocity.x * deltaTime, 0.f });
-        dynamicEntity->syncHitbox();
+        CollisionRectangle sweptArea = startHitbox.merge(endHitbox); // Everything the bullet could touch this tick
 
-		const CollisionRectangle& entityHitbox = dynamicEntity->getHitbox();
+        // Nearby actors come from the tree, and doors from the static grid - only on the layers this bullet can hit
+        std::uint32_t bulletMask = bullet->getCollisionMask();
 
-        for (const auto& wall : m_entities)
+        m_candidates.clear();
+        m_bodyTree.query(sweptArea, bulletMask, [&](int proxyId)
+            {
+                Entity* other = m_bodyTree.getEntity(proxyId);
+                if (other != bullet.get()) // Skips self collision
+                    m_candidates.push_back(other);
+                return true;
+            });
+        m_broadphase.query(sweptArea, bulletMask, m_candidates);
+
+        // Solid tiles come from the tile grid, as the merged colliders covering the swept area
+        m_colliderIds.clear();
+        int tilePairs = 0;
+        if (bulletMask & CollisionLayers::World)
+            tilePairs = m_tileLayer.queryColliders(sweptArea, m_colliderIds);
+
+        if (m_broadphaseStatsEnabled)
         {
-			// Skips self, collectable, player and door collision
-            if (wall.get() == dynamicEntity) continue;          
-            if (wall->getType() == EntityType::Collectable) continue;
-            if (wall->getType() == EntityType::Player) continue;
-            if (wall->getType() == EntityType::Door) continue;
-                
-            // Creates a slimmer hitbox for wall checking
-            CollisionRectangle wallCheck = entityHitbox;
-            wallCheck.m_height -= 2.f;
-            wallCheck.m_yPos += 1.f; // Centres it
+            m_broadphaseStats.bulletPairs += static_cast<int>(m_candidates.size()) + tilePairs;
+            m_broadphaseStats.bruteForcePairs += static_cast<int>(m_entities.size());
+        }
+
+        // Finds the earliest thing the bullet touches along its move - a null hit entity means the world was hit
+        float firstImpact = std::numeric_limits<float>::infinity();
+        Entity* hitEntity = nullptr;
 
-            // Wall Collisions
-            if (wallCheck.intersection(wall->getHitbox()))
+        auto testImpact = [&](const CollisionRectangle& other, Entity* entity)
             {
-                sf::Vector2f pos = dynamicEntity->getPosition();
-                float halfWidth = entityHitbox.m_width / 2.f;
+                float timeOfImpact = 0.f; // Already overlapping counts as being hit at the start of the move
+                if (!startHitbox.intersection(other) && !startHitbox.sweep(displacement.x, displacement.y, other, timeOfImpact))
+                    return; // Misses it
 
-                if (velocity.x > 0) // Moving Right
-                {
-                    float targetLeft = wall->getHitbox().m_xPos - entityHitbox.m_width;
-                    pos.x = targetLeft + halfWidth;
-                }
-                else if (velocity.x < 0) // Moving Left
+                if (timeOfImpact < firstImpact)
                 {
-                    float targetLeft = wall->getHitbox().m_xPos + wall->getHitbox().m_width;
-                    pos.x = targetLeft + halfWidth;
+                    firstImpact = timeOfImpact;
+                    hitEntity = entity;
                 }
+            };
+
+        // Packs the colliders then the actors, so only those overlapping the swept area need the sweep test - found in one batched test
+        m_packedObstacles.clear();
+        // Bullets pass over one-way tiles, so the collider list is filtered first
+        m_colliderIds.erase(std::remove_if(m_colliderIds.begin(), m_colliderIds.end(), [&](int colliderId) { return (m_tileLayer.getColliderProperties(colliderId).flags & TileFlags::OneWay) != 0; }), m_colliderIds.end());
+        for (int colliderId : m_colliderIds)
+            m_packedObstacles.add(m_solidColliders[colliderId]);
+        for (Entity* obstacle : m_candidates)
+            m_packedObstacles.add(obstacle->getHitbox());
+
+        m_obstacleHits.clear();
+        m_packedObstacles.intersectAll(sweptArea, m_obstacleHits);
+
+        int colliderCount = static_cast<int>(m_colliderIds.size());
+        for (int hit : m_obstacleHits)
+        {
+            if (hit < colliderCount)
+                testImpact(m_solidColliders[m_colliderIds[hit]], nullptr);
+            else
+                testImpact(m_candidates[hit - colliderCount]->getHitbox(), m_candidates[hit - colliderCount]);
+        }
 
-                dynamicEntity->setPosition(pos);
-                dynamicEntity->syncHitbox();
-            }
+        // Pulls the bullet back to where it hit, so it is drawn against the surface rather than past it
+        if (firstImpact <= 1.f)
+        {
+            displacement *= firstImpact;
+            bullet->setPosition(startPosition + displacement);
+            bullet->syncHitbox();
+            bullet->deactivate(); // Collision detected, deactivate bullet
+            m_timers.cancel(bullet->getLifetimeTimer()); // So it doesn't expire after being fired again
         }
 
-        // Y
-        dynamicEntity->move({ 0.f, velocity.y * deltaTime });
-        dynamicEntity->syncHitbox();
-		dynamicEntity->setIsGrounded(false); // Resets grounded state each loop
+        updateBody(bullet.get(), displacement);
 
-        for (const auto& floor : m_entities)
+        if (hitEntity)
         {
-            // Skips self, collectable, player and door collision
-            if (floor.get() == dynamicEntity) continue;
-            if (floor->getType() == EntityType::Collectable) continue;
-            if (floor->getType() == EntityType::Player) continue;
-			if (floor->getType() == EntityType::Door) continue;
-
-            // Creates a slimmer hitbox for wall checking
-            CollisionRectangle floorCheck = entityHitbox;
-            floorCheck.m_width -= 2.f;
-            floorCheck.m_xPos += 1.f; // Centres it
+            // Only the player and enemies can be hit, both of which are dynamic - a hit always wakes them
+            if (hitEntity->getType() == EntityType::Enemy || hitEntity->getCollisionLayer() == CollisionLayers::Player)
+                static_cast<DynamicEntity*>(hitEntity)->wake();
+
+            // The damage is dealt by the gameplay phase
+            if (hitEntity->getCollisionLayer() == CollisionLayers::Player)
+                m_contacts.push_back({ bullet.get(), hitEntity, ContactKind::BulletHitPlayer });
+            else if (hitEntity->getType() == EntityType::Enemy)
+                m_contacts.push_back({ bullet.get(), hitEntity, ContactKind::BulletHitEnemy });
+        }
 
-            // Floor Collisions
-            if (floorCheck.intersection(floor->getHitbox()))
-            {
-                sf::Vector2f pos = dynamicEntity->getPosition();
-                float halfHeight = entityHitbox.m_height / 2.f;
+        // Inactive bullets leave the tree until they are fired again
+        if (!bullet->isActive())
+            removeBody(bullet.get());
+    }
 
-                if (velocity.y > 0) // Moving Down (Falling)
-                {
-                    float targetTop = floor->getHitbox().m_yPos - entityHitbox.m_height;
-                    pos.y = targetTop + halfHeight;
+    // The player's contacts with collectables and doors come from the static grid, rather than a pass over every one of them
+    const CollisionRectangle& playerHitbox = getPlayerEntity()->getHitbox();
 
-                    dynamicEntity->setIsGrounded(true);
+    m_candidates.clear();
+    m_broadphase.query(playerHitbox, CollisionLayers::Collectable | CollisionLayers::Door, m_candidates);
 
-                    // Stop falling
-                    dynamicEntity->setVelocity({ velocity.x, 0.f });
-                }
-                else if (velocity.y < 0) // Moving Up (Jumping)
-                {
-                    float targetTop = floor->getHitbox().m_yPos + floor->getHitbox().m_height;
-                    pos.y = targetTop + halfHeight;
-         
-                    // Stop rising
-                    dynamicEntity->setVelocity({ velocity.x, 0.f });
-                }
+    for (Entity* other : m_candidates)
+    {
+        if (!playerHitbox.intersection(other->getHitbox())) continue;
 
-                dynamicEntity->setPosition(pos);
-                dynamicEntity->syncHitbox();
-            }
-        }
+        ContactKind kind = (other->getCollisionLayer() == CollisionLayers::Door) ? ContactKind::PlayerDoor : ContactKind::PlayerCollectable;
+        m_contacts.push_back({ getPlayerEntity(), other, kind });
     }
 
-	// Bullet Collision - Is separate as bullets are not recognised as entities in the main entity vector
-    for (auto& bullet : m_bulletPool)
+    // Trigger volumes are tested against the player and active enemies, only the triggers in the cells they cover are looked at
+    // Frozen enemies aren't tested, so leave any trigger they were in
+    m_triggerEntities.reserve(1 + m_activeEnemies.size());
+    m_triggerEntities.push_back(getPlayerEntity());
+    m_triggerEntities.insert(m_triggerEntities.end(), m_activeEnemies.begin(), m_activeEnemies.end());
+
+    m_triggerVolumes.update(m_triggerEntities, m_triggerEvents);
+}
+
+// Gameplay events - applies the rules for the contacts found by the collision phase, then removes anything destroyed this tick
+void Simulation::resolveGameplay()
+{
+    const CollisionRectangle& playerHitbox = getPlayerEntity()->getHitbox();
+
+    // Every contact the collision phase found, in the order they were found
+    for (const ContactEvent& contact : m_contacts)
     {
-		if (!bullet->isActive()) continue; // Only checks active bullets
+        if (contact.b && contact.b->getDestroy()) continue; // Already handled by an earlier contact this tick, e.g. two bullets finishing the same enemy
 
-		bullet->update(deltaTime); // Ensures the bullet is deactivated after its lifetime
-        bullet->move(bullet->getVelocity() * deltaTime);
-        bullet->syncHitbox();
+        switch (contact.kind)
+        {
+        case ContactKind::PlayerCollectable:
+            m_score += 1; // Increments the score variable
+            contact.b->destroy(); // Marks collectables for destruction upon collision with player
+            m_destroyed.push_back(contact.b);
+            break;
 
-        // Check Collision with World (Walls/Floors)
-        for (const auto& obstacle : m_entities)
+        case ContactKind::PlayerDoor:
         {
-            // Ignore self types and collectables
-            if (obstacle->getType() == EntityType::Collectable ||
-                obstacle->getType() == EntityType::Bullet) continue;
+            // Door Collision - Level Completion
+            float playerCenterX = playerHitbox.m_xPos + (playerHitbox.m_width / 2.f);
+            float doorCenterX = contact.b->getHitbox().m_xPos + (contact.b->getHitbox().m_width / 2.f);
+
+            // Calculate the distance between centers
+            float diffX = std::abs(playerCenterX - doorCenterX);
+
+			// If close enough to the center, mark level as complete - to simulate actually entering the door. Not just touching
+            if (diffX < 4.0f) { m_levelComplete = true; }
+            break;
+        }
+
+        case ContactKind::BulletHitPlayer:
+            getPlayerEntity()->takeDamage(1); // Damages player upon being hit by enemy bullet
+            break;
 
-			// Checks bullet type to determine what it can hit
-			if (bullet->isEnemyBullet()) 
+        case ContactKind::PlayerHazard:
+            // Standing on a hazard touches it every tick, so the player is only hurt again once the cooldown is over
+            if (!m_timers.isPending(m_hazardCooldown))
             {
-                if (obstacle->getType() == EntityType::Enemy) continue; // Enemy bullets ignore enemies
+                getPlayerEntity()->takeDamage(1);
+                m_hazardCooldown = m_timers.schedule(m_timers.ticksFor(HazardCooldown));
             }
-            else
-                if (obstacle->getType() == EntityType::Player) continue; // Player bullets ignore player
+            break;
+
+        case ContactKind::BulletHitEnemy:
+        {
+            Enemy* enemy = static_cast<Enemy*>(contact.b); // Only emitted for enemies
+            enemy->takeDamage(1); // Deals 1 damage to the enemy, marking it destroyed once its health runs out
 
-            if (bullet->getHitbox().intersection(obstacle->getHitbox()))
+            // Check if their health is 0 or below - queues them for removal and adds 5 score if so
+            if (enemy->getHealth() <= 0)
             {
-                bullet->deactivate(); // Collision detected, deactivate bullet
+                m_destroyed.push_back(enemy); // Bullets can reach frozen enemies, so this is the only way the deletion knows about them
+                m_score += 5;
+            }
+            break;
+        }
 
-                // Handles the different bullet types
-				if (bullet->isEnemyBullet()) // Enemy bullet
-                {
-					// Damages player upon being hit by enemy bullet
-                    if (obstacle->getType() == EntityType::Player)
-                        m_player->takeDamage(1);
+        default:
+            break;
+        }
+    }
 
-                }
-				else // Player bullet
+    // Deleting marked entities - only enemies and collectables can be destroyed, and only the ones destroyed this tick are visited
+    // They are removed from the broadphase first so it doesn't hold dangling pointers
+    if (m_destroyed.empty()) return;
+
+    for (Entity* entity : m_destroyed)
+    {
+        if (entity->getType() == EntityType::Enemy)
+        {
+            Enemy* enemy = static_cast<Enemy*>(entity);
+            wakeBodiesIn(enemy->getHitbox(), enemy); // Anything resting on or against it would otherwise be left floating
+            removeBody(enemy);
+            m_triggerVolumes.remove(enemy);
+        }
+        else
+        {
+            m_broadphase.remove(entity);
+        }
+    }
+
+    // The active lists only hold raw pointers, so are cleaned up before the owners are
+    m_activeEnemies.erase(std::remove_if(m_activeEnemies.begin(), m_activeEnemies.end(), [](const Enemy* enemy) { return enemy->getDestroy(); }), m_activeEnemies.end());
+    m_activeCollectables.erase(std::remove_if(m_activeCollectables.begin(), m_activeCollectables.end(), [](const Collectable* collectable) { return collectable->getDestroy(); }), m_activeCollectables.end());
+
+    // Each owner fills the gap with its last entity, so removing costs the same however many are left
+    for (Entity* entity : m_destroyed)
+    {
+        if (entity->getType() == EntityType::Enemy)
+            m_enemies.remove(entity->getHandle());
+        else
+            m_collectables.remove(entity->getHandle());
+    }
+    m_destroyed.clear();
+
+    rebuildEntityView();
+}
+
+// Platforms have already been moved by the integration, so only their tree entries need to follow - the tile layer and merged colliders are never touched
+// Anything grounded on top of a platform before its move is carried the same distance, start and end, so the resolver sees the rider's own move only
+void Simulation::movePlatforms()
+{
+    for (auto& platform : m_platforms)
+    {
+        int body = platform->getBodyIndex();
+        CollisionRectangle startHitbox = m_physics.getStartHitbox(body);
+        sf::Vector2f displacement = { m_physics.m_x[body] - m_physics.m_startX[body], m_physics.m_y[body] - m_physics.m_startY[body] };
+
+        if (displacement.x == 0.f && displacement.y == 0.f) continue; // Didn't move - a platform with a single waypoint or no speed
+
+        // Riders are found by their feet, in a thin strip along the top of the platform where it started
+        CollisionRectangle topStrip(startHitbox.m_xPos, startHitbox.m_yPos - 1.f, 2.f, startHitbox.m_width);
+
+        m_bodyTree.query(topStrip, CollisionLayers::Player | CollisionLayers::Enemy, [&](int proxyId)
+            {
+                int rider = static_cast<DynamicEntity*>(m_bodyTree.getEntity(proxyId))->getBodyIndex();
+                if (m_physics.isFrozen(rider) || !m_physics.hasFlag(rider, BodyFlags::Grounded)) return true;
+
+                CollisionRectangle riderStart = m_physics.getStartHitbox(rider);
+                bool standingOn = std::abs(riderStart.m_yPos + riderStart.m_height - startHitbox.m_yPos) < 1.f &&
+                    riderStart.m_xPos < startHitbox.m_xPos + startHitbox.m_width && riderStart.m_xPos + riderStart.m_width > startHitbox.m_xPos;
+
+                if (standingOn)
                 {
-					// Destroys enemy upon being hit by player bullet
-                    if (obstacle->getType() == EntityType::Enemy) 
-                    {
-                        Enemy* enemy = dynamic_cast<Enemy*>(obstacle.get());
-                        if (enemy)
-                        {
-							enemy->takeDamage(1); // Deals 1 damage to the enemy
-
-							// Check if their health is 0 or below - destroys them and adds 5 score if so
-                            if (enemy->getHealth() <= 0)
-                            {
-                                obstacle->destroy();
-
-								// Checks if the enemy was destroyed to add score
-                                if (enemy->getDestroy())
-                                {
-                                    m_score += 5;
-                                }
-                            }
-                        }
-                    }
+                    m_physics.wake(rider);
+                    m_physics.m_x[rider] += displacement.x;
+                    m_physics.m_y[rider] += displacement.y;
+                    m_physics.m_startX[rider] += displacement.x;
+                    m_physics.m_startY[rider] += displacement.y;
                 }
-                break;
-            }
+
+                return true;
+            });
+
+        updateBody(platform.get(), displacement); // Only the platform's own entry in the tree moves
+
+        // Anything sleeping where the platform now is, or that was resting on it, has to respond to the move
+        wakeBodiesIn(startHitbox.merge(m_physics.getHitbox(body)), platform.get());
+    }
+}
+
+// Whether the area overlaps a moving platform - the enemies' edge checks use it, as platforms aren't in the tile layer
+// Only reads the tree, so is safe to call for several enemies at once
+bool Simulation::isOnPlatform(const CollisionRectangle& area) const
+{
+    bool found = false;
+
+    m_bodyTree.query(area, CollisionLayers::Platform, [&](int proxyId)
+        {
+            found = area.intersection(m_bodyTree.getEntity(proxyId)->getHitbox());
+            return !found; // Stops at the first one
+        });
+
+    return found;
+}
+
+// Resolves the collisions of a body's integrated move one axis at a time - works on the physics store directly, the entity is synced afterwards
+void Simulation::resolveBody(int body)
+{
+    DynamicEntity* owner = m_physics.m_owners[body];
+    float velocityX = m_physics.m_velocityX[body];
+    float velocityY = m_physics.m_velocityY[body];
+    float startX = m_physics.m_startX[body];
+    float startY = m_physics.m_startY[body];
+    float endY = m_physics.m_y[body];
+    float halfWidth = m_physics.m_width[body] / 2.f;
+    float halfHeight = m_physics.m_height[body] / 2.f;
+
+    // X - the body is put back to its starting height, so only the horizontal part of the move is resolved first
+    CollisionRectangle startHitbox = m_physics.getStartHitbox(body); // Resolving never pushes back past where the move started
+    m_physics.m_y[body] = startY;
+
+    CollisionRectangle entityHitbox = m_physics.getHitbox(body);
+
+    int pairs = gatherObstacles(startHitbox.merge(entityHitbox), owner);
+
+    if (m_broadphaseStatsEnabled)
+    {
+        m_broadphaseStats.xPassPairs += pairs;
+        m_broadphaseStats.bruteForcePairs += static_cast<int>(m_entities.size());
+    }
+
+    bool isPlayer = owner == getPlayerEntity(); // Only the player is hurt by hazards
+
+    for (std::size_t i = 0; i < m_obstacles.size(); ++i)
+    {
+        const CollisionRectangle& wall = m_obstacles[i];
+        const TileProperties& properties = m_obstacleProperties[i];
+        if (!(properties.flags & TileFlags::Solid)) continue; // One-way tiles and slopes are never walls
+
+        // Creates a slimmer hitbox for wall checking
+        CollisionRectangle wallCheck = entityHitbox;
+        wallCheck.m_height -= 2.f;
+        wallCheck.m_yPos += 1.f; // Centres it
+
+        // The same box at the start of the move, swept over what is left of it so thin walls can't be skipped at low tick rates
+        CollisionRectangle startWallCheck = startHitbox;
+        startWallCheck.m_height -= 2.f;
+        startWallCheck.m_yPos += 1.f;
+        float timeOfImpact;
+
+        // Wall Collisions
+        if (wallCheck.intersection(wall) || startWallCheck.sweep(entityHitbox.m_xPos - startHitbox.m_xPos, 0.f, wall, timeOfImpact))
+        {
+            if (velocityX > 0) // Moving Right
+                m_physics.m_x[body] = wall.m_xPos - entityHitbox.m_width + halfWidth;
+            else if (velocityX < 0) // Moving Left
+                m_physics.m_x[body] = wall.m_xPos + wall.m_width + halfWidth;
+
+            entityHitbox = m_physics.getHitbox(body);
+
+            if (isPlayer && (properties.flags & TileFlags::Hazard))
+                m_contacts.push_back({ owner, nullptr, ContactKind::PlayerHazard });
         }
     }
 
-    const CollisionRectangle& playerHitbox = m_player->getHitbox();
+    // Y
+    startHitbox = entityHitbox;
+    m_physics.m_y[body] = endY;
+    bool wasGrounded = m_physics.hasFlag(body, BodyFlags::Grounded); // Lets a body walking down a slope stay on it
+    m_physics.setFlag(body, BodyFlags::Grounded, false); // Resets grounded state each loop
+
+    entityHitbox = m_physics.getHitbox(body);
 
-	// Door Collision - Level Completion
-    for (const auto& entity : m_entities)
+    pairs = gatherObstacles(startHitbox.merge(entityHitbox), owner);
+
+    if (m_broadphaseStatsEnabled)
     {
-        if (entity->getType() == EntityType::Door)
+        m_broadphaseStats.yPassPairs += pairs;
+        m_broadphaseStats.bruteForcePairs += static_cast<int>(m_entities.size());
+    }
+
+    for (std::size_t i = 0; i < m_obstacles.size(); ++i)
+    {
+        const CollisionRectangle& floor = m_obstacles[i];
+        const TileProperties& properties = m_obstacleProperties[i];
+
+        // Slopes hold the body up by its centre, at the surface's height under it
+        if (properties.flags & TileFlags::Slope)
         {
-            if (playerHitbox.intersection(entity->getHitbox()))
+            float centreX = entityHitbox.m_xPos + entityHitbox.m_width / 2.f;
+            if (centreX < floor.m_xPos || centreX > floor.m_xPos + floor.m_width) continue; // Held by whatever is under its centre instead
+
+            float surfaceY = floor.m_yPos + floor.m_height * (1.f - properties.surfaceHeight((centreX - floor.m_xPos) / floor.m_width));
+            float feetY = entityHitbox.m_yPos + entityHitbox.m_height;
+            float startFeetY = startHitbox.m_yPos + startHitbox.m_height;
+
+            // Walking up lifts the body by at most a step, walking down keeps it on the surface rather than falling a little each tick
+            bool reachesSurface = feetY >= surfaceY || (wasGrounded && surfaceY - feetY <= SlopeSnapDistance);
+            if (velocityY >= 0.f && reachesSurface && startFeetY <= surfaceY + SlopeStepHeight)
             {
-                float playerCenterX = playerHitbox.m_xPos + (playerHitbox.m_width / 2.f);
+                m_physics.m_y[body] = surfaceY - entityHitbox.m_height + halfHeight;
+                m_physics.setFlag(body, BodyFlags::Grounded, true);
+                m_physics.m_velocityY[body] = 0.f;
+
+                entityHitbox = m_physics.getHitbox(body);
+            }
+            continue;
+        }
 
-                float doorCenterX = entity->getHitbox().m_xPos + (entity->getHitbox().m_width / 2.f);
+        // One-way tiles are only landed on from above - the feet have to start the move no lower than the tile's top, give or take a pixel of rounding
+        if ((properties.flags & TileFlags::OneWay) && (velocityY <= 0.f || startHitbox.m_yPos + startHitbox.m_height > floor.m_yPos + 1.f))
+            continue;
 
-                // Calculate the distance between centers
-                float diffX = std::abs(playerCenterX - doorCenterX);
+        // Creates a slimmer hitbox for wall checking
+        CollisionRectangle floorCheck = entityHitbox;
+        floorCheck.m_width -= 2.f;
+        floorCheck.m_xPos += 1.f; // Centres it
 
-				// If close enough to the center, mark level as complete - to simulate actually entering the door. Not just touching
-                if (diffX < 4.0f) { m_levelComplete = true; }
+        // Swept from the start of the move as well, so a fast fall can't pass through a floor
+        CollisionRectangle startFloorCheck = startHitbox;
+        startFloorCheck.m_width -= 2.f;
+        startFloorCheck.m_xPos += 1.f;
+        float timeOfImpact;
+
+        // Floor Collisions
+        if (floorCheck.intersection(floor) || startFloorCheck.sweep(0.f, entityHitbox.m_yPos - startHitbox.m_yPos, floor, timeOfImpact))
+        {
+            if (velocityY > 0) // Moving Down (Falling)
+            {
+                m_physics.m_y[body] = floor.m_yPos - entityHitbox.m_height + halfHeight;
+                m_physics.setFlag(body, BodyFlags::Grounded, true);
+                m_physics.m_velocityY[body] = 0.f; // Stop falling
+            }
+            else if (velocityY < 0) // Moving Up (Jumping)
+            {
+                m_physics.m_y[body] = floor.m_yPos + floor.m_height + halfHeight;
+                m_physics.m_velocityY[body] = 0.f; // Stop rising
             }
+
+            entityHitbox = m_physics.getHitbox(body);
+
+            if (isPlayer && (properties.flags & TileFlags::Hazard))
+                m_contacts.push_back({ owner, nullptr, ContactKind::PlayerHazard });
         }
     }
 
-	// Collectable Collision
-    for (auto& entity : m_entities)
+    sf::Vector2f displacement = { m_physics.m_x[body] - startX, m_physics.m_y[body] - startY };
+
+    // Keeps the tree in step with the body's resolved position
+    updateBody(owner, displacement);
+
+    // Anything sleeping where the body was or now is has to respond to the move, whatever layers the body itself collides with
+    // Enemies don't collide with the player, but a player asleep on top of one still has to fall when it walks away
+    if (displacement.x != 0.f || displacement.y != 0.f)
+        wakeBodiesIn(startHitbox.merge(m_physics.getHitbox(body)), owner);
+}
+
+// Fills m_obstacles with the tile colliders and blocking entities overlapping the area, and m_obstacleProperties with how they collide, returns how many candidates were looked at
+int Simulation::gatherObstacles(const CollisionRectangle& area, const Entity* self)
+{
+    m_obstacles.clear();
+    m_obstacleProperties.clear();
+
+    std::uint32_t mask = self->getCollisionMask();
+    int pairs = 0;
+
+    // Tiles come from the grid, as the merged colliders covering the area
+    if (mask & CollisionLayers::World)
     {
-		// Marks collectables for destruction upon collision with player
-        if (entity->getType() == EntityType::Collectable && playerHitbox.intersection(entity->getHitbox()))
+        m_colliderIds.clear();
+        pairs += m_tileLayer.queryColliders(area, m_colliderIds);
+
+        for (int colliderId : m_colliderIds)
         {
-            m_score += 1; // Increments the score variable
-            entity->destroy();
+            m_obstacles.push_back(m_solidColliders[colliderId]);
+            m_obstacleProperties.push_back(m_tileLayer.getColliderProperties(colliderId));
         }
     }
 
-	// Trigger Collision
-    for (auto& pair : m_triggerColliders)
+    // Other moving bodies come from the tree, subtrees on layers outside the mask are never visited
+    // Collectables and doors never block movement, so the static grid isn't needed
+    m_bodyTree.query(area, mask, [&](int proxyId)
+        {
+            pairs++;
+            Entity* other = m_bodyTree.getEntity(proxyId);
+
+            // Only dynamic entities are in the tree, so their current hitbox comes from the physics store
+            if (other == self) return true; // Skips self collision
+
+            int body = static_cast<DynamicEntity*>(other)->getBodyIndex();
+            CollisionRectangle hitbox = m_physics.getHitbox(body);
+
+            // A moving body touching a sleeping one wakes it, so it can be pushed or fall next tick
+            if (m_physics.isSleeping(body) && area.intersection(hitbox))
+                m_physics.wake(body);
+
+            m_obstacles.push_back(hitbox);
+            m_obstacleProperties.push_back(TileProperties{});
+
+            return true;
+        });
+
+    // The broadphase only narrows it down to nearby cells and fat boxes, so keeps just the obstacles actually overlapping the area
+    // These are found in one batched test, rather than one branchy test per obstacle in the resolver
+    m_packedObstacles.clear();
+    for (const CollisionRectangle& obstacle : m_obstacles)
+        m_packedObstacles.add(obstacle);
+
+    m_obstacleHits.clear();
+    m_packedObstacles.intersectAll(area, m_obstacleHits);
+
+    // The hits are in ascending order, so can be compacted in place
+    for (std::size_t i = 0; i < m_obstacleHits.size(); ++i)
+    {
+        m_obstacles[i] = m_obstacles[m_obstacleHits[i]];
+        m_obstacleProperties[i] = m_obstacleProperties[m_obstacleHits[i]];
+    }
+    m_obstacles.resize(m_obstacleHits.size());
+    m_obstacleProperties.resize(m_obstacleHits.size());
+
+    return pairs;
+}
+
+// Wakes every sleeping body overlapping the area, apart from the one given
+void Simulation::wakeBodiesIn(const CollisionRectangle& area, const Entity* except)
+{
+    m_bodyTree.query(area, CollisionLayers::All, [&](int proxyId)
+        {
+            Entity* other = m_bodyTree.getEntity(proxyId);
+            if (other == except) return true;
+
+            int body = static_cast<DynamicEntity*>(other)->getBodyIndex();
+            if (m_physics.isSleeping(body) && area.intersection(m_physics.getHitbox(body)))
+                m_physics.wake(body);
+
+            return true;
+        });
+}
+
+void Simulation::addBody(DynamicEntity* body)
+{
+    body->setProxyId(m_bodyTree.createProxy(body->getHitbox(), body, body->getCollisionLayer()));
+}
+
+void Simulation::removeBody(DynamicEntity* body)
+{
+    if (body->getProxyId() == DynamicAabbTree::NullNode) return; // Not in the tree
+
+    m_bodyTree.destroyProxy(body->getProxyId());
+    body->setProxyId(DynamicAabbTree::NullNode);
+}
+
+void Simulation::updateBody(DynamicEntity* body, sf::Vector2f displacement)
+{
+    if (body->getProxyId() == DynamicAabbTree::NullNode) return; // Not in the tree
+
+    m_bodyTree.moveProxy(body->getProxyId(), m_physics.getHitbox(body->getBodyIndex()), displacement);
+}
+
+// Fires the first inactive bullet in the pool, if there is one
+void Simulation::fireBullet(sf::Vector2f position, sf::Vector2f velocity, bool isEnemy)
+{
+    for (auto& bullet : m_bulletPool)
     {
-        // None currently implemented
-	}
+        if (!bullet->isActive())
+        {
+            bullet->fire(position, velocity);
 
-    // Deleting marked entities
-    m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(), [](const std::unique_ptr<Entity>& entity) { return entity->getDestroy(); }), m_entities.end());
+            std::uint32_t layer = isEnemy ? CollisionLayers::EnemyBullet : CollisionLayers::PlayerBullet;
+            bullet->setCollisionLayer(layer, m_collisionFilter.getMask(layer));
+
+            addBody(bullet.get()); // Active bullets are tracked in the tree
+
+            // Expires the bullet once its lifetime is over, unless it hits something first
+            m_timers.cancel(bullet->getLifetimeTimer());
+            bullet->getLifetimeTimer() = m_timers.schedule(m_timers.ticksFor(Bullet::Lifetime), [this, expired = bullet.get()]()
+                {
+                    expired->deactivate();
+                    removeBody(expired);
+                });
+            break; // We fired one, stop looking
+        }
+    }
 }
 
 void Simulation::loadLevel(const std::string& filename)
@@ -380,8 +960,18 @@ void Simulation::loadLevel(const std::string& filename)
         return;
     }
 
-	// Clears existing entities and bullets
-    m_entities.clear();
+	// Clears existing entities and bullets - the active lists first, as they point into the containers
+    m_activeEnemies.clear();
+    m_activeCollectables.clear();
+    m_destroyed.clear();
+    m_broadphase.clear();
+    m_bodyTree.clear();
+    m_tiles.clear();
+    m_enemies.clear();
+    m_collectables.clear();
+    m_doors.clear();
+    m_platforms.clear();
+    m_timers.clear(); // Bullet lifetimes point at the pool, and cooldowns don't carry over between levels
     m_bulletPool.clear();
 
     // Bullet setup
@@ -389,55 +979,202 @@ void Simulation::loadLevel(const std::string& filename)
     // Pre-create a pool of bullets
     for (int i = 0; i < 20; ++i)
     {
-        m_bulletPool.push_back(std::make_unique<Bullet>(bullet));
+        m_bulletPool.push_back(std::make_unique<Bullet>(m_physics, bullet));
     }
 
     std::string line;
-    int y = 0;
-	int maxX = 0; // To calculate level width (for the level size variable, used by the camera)
+    std::vector<std::string> lines;
+    std::vector<std::string> triggerLines;
+    std::vector<std::string> platformLines;
     float tileSize = 18.f; // How large a single floor tile is
 
-	// Reads each line from the file
+	// Reads each line from the file - they are parsed afterwards, several rows at once
     while (std::getline(file, line))
     {
-		std::stringstream ss(line); // String stream for parsing
-		std::string cell;
-        int x = 0;
+        // Trigger volumes are listed after the tile rows, as "trigger, name, column, row, columns, rows"
+        // Moving platforms likewise, as "platform, speed, column, row, column, row, ..." - the tiles their left end visits, in order
+        if (line.rfind("trigger", 0) == 0)
+            triggerLines.push_back(line);
+        else if (line.rfind("platform", 0) == 0)
+            platformLines.push_back(line);
+        else
+            lines.push_back(line);
+    }
 
-		// Separates each cell by commas
-        while (std::getline(ss, cell, ','))
+    std::vector<std::vector<int>> rows(lines.size()); // The parsed IDs, read fully first so the tile grid can be sized
+
+    // Each row is only written by the job parsing its line
+    m_jobSystem.parallelFor(static_cast<int>(lines.size()), 16, [&](int begin, int end)
         {
-			int tileId = std::stoi(cell); // Converts string to integer
-			if (tileId != 0) // 0 represents empty space
+            for (int i = begin; i < end; ++i)
             {
-                createEntityFromId(tileId, x * tileSize, y * tileSize);
+                std::stringstream ss(lines[i]); // String stream for parsing
+                std::string cell;
+
+                // Separates each cell by commas
+                while (std::getline(ss, cell, ','))
+                    rows[i].push_back(std::stoi(cell)); // Converts string to integer
             }
-			x++;
+        });
+
+	int maxX = 0; // To calculate level width (for the level size variable, used by the camera)
+    for (const std::vector<int>& row : rows)
+        maxX = std::max(maxX, static_cast<int>(row.size()));
+
+    int rowCount = static_cast<int>(rows.size());
+    m_tileLayer.resize(maxX, rowCount, tileSize);
+
+    // Creates the entities, tiles are also recorded in the tile grid for collisions
+    for (int row = 0; row < rowCount; ++row)
+    {
+        for (int x = 0; x < static_cast<int>(rows[row].size()); ++x)
+        {
+            int tileId = rows[row][x];
+			if (tileId != 0) // 0 represents empty space
+                createEntityFromId(tileId, x * tileSize, row * tileSize);
+        }
+    }
+
+	m_levelSize = { maxX * tileSize, rowCount * tileSize }; // Sets level size based on loaded tiles
+
+    m_triggerVolumes.clear();
+    for (const std::string& triggerLine : triggerLines)
+    {
+        std::stringstream ss(triggerLine);
+        std::string cell;
+        std::vector<std::string> cells;
+
+        while (std::getline(ss, cell, ','))
+            cells.push_back(cell);
+
+        if (cells.size() != 6)
+        {
+            std::cout << "Skipping malformed trigger: " << triggerLine << std::endl;
+            continue;
+        }
+
+        std::string name = cells[1];
+        name.erase(0, name.find_first_not_of(' ')); // Names are written after a comma and a space
+
+        // Positioned and sized in tiles, like everything else in the level
+        m_triggerVolumes.add(name, CollisionRectangle(std::stoi(cells[2]) * tileSize, std::stoi(cells[3]) * tileSize, std::stoi(cells[5]) * tileSize, std::stoi(cells[4]) * tileSize));
+    }
+
+    const StaticSprite& platformSprite = m_animationManager.getStaticSprite("platform");
+    sf::Vector2f platformHalfSize = { platformSprite.textureRect.size.x / 2.f, platformSprite.textureRect.size.y / 2.f };
+
+    for (const std::string& platformLine : platformLines)
+    {
+        std::stringstream ss(platformLine);
+        std::string cell;
+        std::vector<std::string> cells;
+
+        while (std::getline(ss, cell, ','))
+            cells.push_back(cell);
+
+        // The speed, then at least two waypoints
+        if (cells.size() < 6 || cells.size() % 2 != 0)
+        {
+            std::cout << "Skipping malformed platform: " << platformLine << std::endl;
+            continue;
         }
-        if (x > maxX) maxX = x;
-        y++;
+
+        std::vector<sf::Vector2f> path;
+        for (std::size_t i = 2; i + 1 < cells.size(); i += 2)
+            path.push_back({ std::stoi(cells[i]) * tileSize + platformHalfSize.x, std::stoi(cells[i + 1]) * tileSize + platformHalfSize.y });
+
+        auto platform = std::make_unique<MovingPlatform>(m_physics, platformSprite, std::move(path), std::stof(cells[1]));
+        assignCollisionLayer(*platform, CollisionLayers::Platform);
+        m_platforms.push_back(std::move(platform));
+    }
+
+	// Bakes the solid tiles into as few colliders as possible, so physics tests a handful of large boxes rather than every tile
+    m_solidColliders.clear();
+    m_solidTileCount = m_tileLayer.bakeColliders(m_solidColliders);
+
+	// Precomputes where the floor runs along each row, for the enemies' edge checks
+    m_tileLayer.buildWalkableSpans();
+
+    rebuildEntityView();
+
+	// Fills the broadphase - hitboxes are synced first as entities have only just been positioned, static ones already were when created
+	// Moving bodies, platforms included, go in the tree, collectables and doors in the static grid, and tiles are handled by the tile grid
+    for (Entity* entity : getMovingEntities())
+        entity->syncHitbox();
+
+    if (getPlayerEntity())
+        addBody(getPlayerEntity());
+
+    // Enemies start frozen, the first tick activates the ones near the camera
+    for (auto& enemy : m_enemies)
+    {
+        addBody(enemy.get());
+        enemy->setFrozen(true);
     }
 
-	m_levelSize = { maxX * tileSize, y * tileSize }; // Sets level size based on loaded tiles
+    for (auto& platform : m_platforms)
+        addBody(platform.get());
+
+    for (auto& collectable : m_collectables)
+        m_broadphase.insert(collectable.get());
+
+    for (auto& door : m_doors)
+        m_broadphase.insert(door.get());
+
+    // The structures kept between ticks are sized for the whole level up front, so the ticks themselves never have to grow them
+    // The lists only needed for one tick come from the frame arena instead
+    std::size_t bodyCount = 1 + m_enemies.size() + m_platforms.size() + m_bulletPool.size();
+    m_bodyTree.reserve(static_cast<int>(bodyCount));
+    m_timers.reserve(static_cast<int>(bodyCount) + 1); // A lifetime per bullet, a cooldown per shooter, and the hazard cooldown
+    m_activeEnemies.reserve(m_enemies.size());
+    m_activeCollectables.reserve(m_collectables.size());
 
 	// Ensures all enemies have reference to the player
-    if (m_player)
+    if (getPlayerEntity())
     {
-        for (auto& entity : m_entities)
+        for (auto& enemy : m_enemies)
         {
-            // Check if it's an enemy
-            if (entity->getType() == EntityType::Enemy)
-            {
-                // Dynamic cast to safely access Enemy-specific functions
-                if (auto* enemy = dynamic_cast<Enemy*>(entity.get()))
-                {
-                    enemy->setTarget(m_player);
-                }
-            }
+            enemy->setTarget(&m_players, m_player);
+            enemy->setWorld(&m_tileLayer); // For line of sight
+            enemy->setTimers(&m_timers); // For the shooting cooldown
         }
     }
 }
 
+// Rebuilds the list of every entity, in the order they are drawn - tiles at the back and the player at the front
+void Simulation::rebuildEntityView()
+{
+    m_entities.clear();
+    m_entities.reserve(m_tiles.size() + m_doors.size() + m_platforms.size() + m_collectables.size() + m_enemies.size() + 1);
+
+    for (auto& tile : m_tiles)
+        m_entities.push_back(tile.get());
+
+    for (auto& door : m_doors)
+        m_entities.push_back(door.get());
+
+    for (auto& platform : m_platforms)
+        m_entities.push_back(platform.get());
+
+    for (auto& collectable : m_collectables)
+        m_entities.push_back(collectable.get());
+
+    for (auto& enemy : m_enemies)
+        m_entities.push_back(enemy.get());
+
+    if (getPlayerEntity())
+        m_entities.push_back(getPlayerEntity());
+
+    // The static entities are kept at the front, so they can be drawn as one block without interpolation
+    // Only tiles and doors are static, which are first anyway - the partition keeps that true for anything else flagged static
+    // It is only run when needed, as the stable partition allocates a buffer and this is rebuilt mid game whenever something is destroyed
+    auto isStatic = [](const Entity* entity) { return entity->isStatic(); };
+    if (!std::is_partitioned(m_entities.begin(), m_entities.end(), isStatic))
+        std::stable_partition(m_entities.begin(), m_entities.end(), isStatic);
+
+    m_staticEntityCount = static_cast<std::size_t>(std::partition_point(m_entities.begin(), m_entities.end(), isStatic) - m_entities.begin());
+}
+
 void Simulation::createEntityFromId(int id, float x, float y)
 {
 	// Offset to centre the entity in the tile
@@ -453,43 +1190,53 @@ void Simulation::createEntityFromId(int id, float x, float y)
         case 999: // Player
         {
             // Only creates the player if it doesn't already exist
-            if (!m_player)
+            if (!getPlayerEntity())
             {
-                auto player = std::make_unique<PlayerEntity>(m_animationManager);
-                m_player = player.get();
-                m_entities.push_back(std::move(player));
-                m_inputManager.addListener(m_player);
+                auto player = std::make_unique<PlayerEntity>(m_physics, m_animationManager);
+                assignCollisionLayer(*player, CollisionLayers::Player);
+                m_inputManager.addListener(player.get());
+                player->setTimers(&m_timers); // For the shooting cooldown
+                m_player = m_players.add(std::move(player));
             }
-            m_player->setPosition(pos);
+            getPlayerEntity()->setPosition(pos);
+            getPlayerEntity()->setPreviousPosition(pos);
         }
         break;
         case 998: // Coin
         {
             auto coin = std::make_unique<Collectable>(m_animationManager.getAnimation("coin"));
+            assignCollisionLayer(*coin, CollisionLayers::Collectable);
             coin->setPosition(pos);
-            m_entities.push_back(std::move(coin));
+            coin->setPreviousPosition(pos);
+            m_collectables.add(std::move(coin));
         }
         break;
         case 997: // Patrolling Enemy
         {
-            auto enemy = std::make_unique<Enemy>(m_animationManager, 150.f); // 150.f patrol range
+            auto enemy = std::make_unique<Enemy>(m_physics, m_animationManager, 150.f); // 150.f patrol range
+            assignCollisionLayer(*enemy, CollisionLayers::Enemy);
             enemy->setPosition(pos);
-            m_entities.push_back(std::move(enemy));
+            enemy->setPreviousPosition(pos);
+            m_enemies.add(std::move(enemy));
         }
         break;
         case 996: // Stationary Enemy
         {
-            auto enemy = std::make_unique<Enemy>(m_animationManager, 0.f); // 0.f patrol range - stationary
+            auto enemy = std::make_unique<Enemy>(m_physics, m_animationManager, 0.f); // 0.f patrol range - stationary
+            assignCollisionLayer(*enemy, CollisionLayers::Enemy);
             enemy->setPosition(pos);
-            m_entities.push_back(std::move(enemy));
+            enemy->setPreviousPosition(pos);
+            m_enemies.add(std::move(enemy));
         }
         break;
         case 995: // Door (Level Exit)
         {
             const StaticSprite& sprite = m_animationManager.getStaticSprite("door");
             auto door = std::make_unique<Door>(sprite);
+            assignCollisionLayer(*door, CollisionLayers::Door);
             door->setPosition(pos);
-            m_entities.push_back(std::move(door));
+            door->makeStatic();
+            m_doors.push_back(std::move(door));
 		}
         break;
         }
@@ -506,8 +1253,14 @@ void Simulation::createEntityFromId(int id, float x, float y)
         const StaticSprite& sprite = m_animationManager.getStaticSprite(tileName);
 
         auto tile = std::make_unique<Entity>(sprite);
+        assignCollisionLayer(*tile, CollisionLayers::World);
         tile->setPosition(pos);
-        m_entities.push_back(std::move(tile));
+        tile->makeStatic();
+        m_tiles.push_back(std::move(tile));
+
+		// Records the tile in the grid, so physics can find it by index rather than testing the entity
+        float tileSize = m_tileLayer.getTileSize();
+        m_tileLayer.setTile(static_cast<int>(x / tileSize), static_cast<int>(y / tileSize), id);
     }
 	catch (const std::exception&) // Missing texture or invalid ID
     {
@@ -6,9 +6,23 @@
 #include "Bullet.h"
 #include "Enemy.h"
 #include "door.h"
+#include "MovingPlatform.h"
 #include "InputManager.h"
 #include "CollisionRectangle.h"
+#include "SpatialHash.h"
+#include "TileLayer.h"
+#include "DynamicAabbTree.h"
+#include "PhysicsStore.h"
+#include "PackedRectangles.h"
+#include "JobSystem.h"
+#include "ContactEvent.h"
+#include "TriggerVolumes.h"
+#include "TimerWheel.h"
+#include "EntityRegistry.h"
+#include "FrameArena.h"
 #include <vector>
+#include <memory_resource>
+#include <span>
 #include <memory>
 #include <iostream>
 #include <unordered_map>
@@ -16,10 +30,22 @@
 #include <fstream>
 #include <sstream>
 
+// Per-tick broadphase counters, used to compare the candidate pairs tested against the old brute force approach
+struct BroadphaseStats
+{
+    int xPassPairs{ 0 };
+    int yPassPairs{ 0 };
+    int edgeSensorPairs{ 0 };
+    int bulletPairs{ 0 };
+    int bruteForcePairs{ 0 }; // How many pairs the same tick would have tested by scanning every entity
+
+    int total() const { return xPassPairs + yPassPairs + edgeSensorPairs + bulletPairs; }
+};
+
 class Simulation
 {
 public:
-    Simulation(TextureManager& textureManager);
+    Simulation(TextureManager& textureManager, JobSystem& jobSystem);
 
 	void reset(); // Resets the simulation to its initial state
 	bool isGameOver() const; // Checks whether the game is over (player health <= 0)
@@ -30,30 +56,166 @@ public:
     sf::Vector2f getLevelSize() const { return m_levelSize; }
 
     // A getter function for the entities for use in the graphics (for rendering)
-    const std::vector<std::unique_ptr<Entity>>& getEntities() const { return m_entities; }
+    const std::vector<Entity*>& getEntities() const { return m_entities; }
+
+    // The same entities split in two - the static ones come first, and are drawn without interpolation as they never move
+    std::span<Entity* const> getStaticEntities() const { return std::span<Entity* const>(m_entities).first(m_staticEntityCount); }
+    std::span<Entity* const> getMovingEntities() const { return std::span<Entity* const>(m_entities).subspan(m_staticEntityCount); }
 
-	const PlayerEntity* getPlayer() const { return m_player; } //  Getter for the player entity, for use in graphics
+	const PlayerEntity* getPlayer() const { return m_players.get(m_player); } //  Getter for the player entity, for use in graphics - null if there isn't one
+
+    const TileLayer& getTileLayer() const { return m_tileLayer; }
+
+    // Casts a ray through the level's tiles, returning whether it hit one before reaching the end - see TileLayer::raycast
+    bool raycast(sf::Vector2f from, sf::Vector2f to, TileRaycastHit& hit) const { return m_tileLayer.raycast(from.x, from.y, to.x, to.y, hit); }
+    int getSolidTileCount() const { return m_solidTileCount; } // How many colliders there were before merging
+    const DynamicAabbTree& getBodyTree() const { return m_bodyTree; }
 
     bool isLevelComplete() const { return m_levelComplete; }
     int getScore() const { return m_score; } // For use in the graphics (game over screen)
 
 	// Colliders
-    std::vector<CollisionRectangle> m_solidColliders;
-    std::unordered_map<std::string, CollisionRectangle> m_triggerColliders;
+    std::vector<CollisionRectangle> m_solidColliders; // The level's colliding tiles, merged into as few rectangles as possible at load - how each collides is kept by the tile layer
+
+    // Trigger volumes loaded from the level, and the transitions found in them last tick
+    const TriggerVolumes& getTriggerVolumes() const { return m_triggerVolumes; }
+    std::span<const TriggerEvent> getTriggerEvents() const { return m_triggerEvents; }
 
 	// A getter function for the bullets for use in the graphics (for rendering)
     const std::vector<std::unique_ptr<Bullet>>& getBullets() const { return m_bulletPool; }
 
-    // Debugging hitbox visualisers
-    sf::RectangleShape m_triggerHitboxVisualiser;
+    // Broadphase debugging - when enabled the candidate pairs tested each tick are counted
+    void setBroadphaseStatsEnabled(bool enabled) { m_broadphaseStatsEnabled = enabled; }
+    bool isBroadphaseStatsEnabled() const { return m_broadphaseStatsEnabled; }
+    const BroadphaseStats& getBroadphaseStats() const { return m_broadphaseStats; }
+
+    std::span<const ContactEvent> getContacts() const { return m_contacts; } // The contacts found by the last tick's collision phase
+
+    // Wakes every sleeping body overlapping the area, apart from the one given - for when what they rest on changes
+    void wakeBodiesIn(const CollisionRectangle& area, const Entity* except = nullptr);
+
+    // Bodies resolved and left sleeping last tick, for the debug overlay
+    int getAwakeBodyCount() const { return m_awakeBodyCount; }
+    int getSleepingBodyCount() const { return m_sleepingBodyCount; }
+    int getFrozenBodyCount() const { return m_frozenBodyCount; }
+
+    const TimerWheel& getTimers() const { return m_timers; }
+    const FrameArena& getFrameArena() const { return m_frameArena; }
+
+    InputManager& getInputManager() { return m_inputManager; } // For feeding in scripted input
+
+    // Activation region - only enemies and collectables within the margin of the view are simulated, the rest are frozen where they are
+    void setActivationView(const sf::FloatRect& view) { m_activationView = view; } // The camera's view, set by Graphics each frame
+    void setActivationMargin(float margin) { m_activationMargin = margin; }
+    float getActivationMargin() const { return m_activationMargin; }
+    void setActivationEnabled(bool enabled) { m_activationEnabled = enabled; }
+    bool isActivationEnabled() const { return m_activationEnabled; }
+    int getActiveEnemyCount() const { return static_cast<int>(m_activeEnemies.size()); }
+    int getEnemyCount() const { return static_cast<int>(m_enemies.size()); }
+    int getActiveCollectableCount() const { return static_cast<int>(m_activeCollectables.size()); }
+    int getCollectableCount() const { return static_cast<int>(m_collectables.size()); }
+
+    // Whether the behaviour phase spreads the enemies and collectables across threads - the results are identical either way
+    void setParallelUpdate(bool parallel) { m_parallelUpdate = parallel; }
+    bool isParallelUpdate() const { return m_parallelUpdate; }
 private:
+    JobSystem& m_jobSystem; // Spreads the behaviour phase and level parsing across cores
     AnimationManager m_animationManager;
     InputManager m_inputManager;
 
-    std::vector<std::unique_ptr<Entity>> m_entities; // Scalable approach used for updating and rendering
+    PhysicsStore m_physics; // Physics state of every dynamic entity - declared before the entities, so it outlives them
+    TimerWheel m_timers; // Bullet lifetimes and shooting cooldowns, advanced once per tick
+
+    // Entities are owned in a container per type, so each per-tick loop only walks the entities it needs without casting
+    std::vector<std::unique_ptr<Entity>> m_tiles;
+    // Those that can be destroyed mid-level are held in registries, so they are removed in O(1) and can be referred to by handle
+    EntityRegistry<Enemy> m_enemies;
+    EntityRegistry<Collectable> m_collectables;
+    std::vector<std::unique_ptr<Door>> m_doors;
+    std::vector<std::unique_ptr<MovingPlatform>> m_platforms;
+    EntityRegistry<PlayerEntity> m_players; // Only ever holds the one player, but lets enemies keep a handle to it that goes stale when it is replaced
+    EntityHandle m_player;
+    PlayerEntity* getPlayerEntity() const { return m_players.get(m_player); } // The player, mutable, or null if there isn't one
+
+    std::vector<Entity*> m_entities; // Every entity in draw order, for rendering and anything that needs all of them
+
+    // The enemies and collectables inside the activation region, refilled each tick - the only ones the per-tick loops visit
+    // Not in the frame arena, as each tick starts from the last one's lists - to store previous positions and freeze the enemies that left
+    std::vector<Enemy*> m_activeEnemies;
+    std::vector<Collectable*> m_activeCollectables;
+
+    // Backs the lists below, which are only needed for one tick - they stay readable until the next tick starts, then are dropped and the arena reset
+    FrameArena m_frameArena;
+    void resetFrameArena();
+
+    std::pmr::vector<Entity*> m_destroyed{ &m_frameArena }; // Enemies and collectables destroyed this tick, removed at the end of it
+
+    std::pmr::vector<ContactEvent> m_contacts{ &m_frameArena }; // Filled by the collision phase, consumed by the gameplay phase
+
+    TriggerVolumes m_triggerVolumes;
+    std::pmr::vector<TriggerEvent> m_triggerEvents{ &m_frameArena }; // Filled alongside the contacts
+    std::pmr::vector<Entity*> m_triggerEntities{ &m_frameArena }; // The entities tested against the triggers
+
+    sf::FloatRect m_activationView; // Empty until Graphics sets it, in which case the region is centred on the player
+    float m_activationMargin{ 90.f }; // How far past the view entities are still simulated, five tiles
+    bool m_activationEnabled{ true };
+    static constexpr sf::Vector2f DefaultActivationSize{ 320.f, 180.f }; // The size of the game view
+    CollisionRectangle getActivationArea() const;
+    void updateActivation();
+    void rebuildEntityView(); // Refills m_entities, called whenever an entity is added or removed
+    std::size_t m_staticEntityCount{ 0 }; // How many entities at the front of m_entities are static
+
+    // The phases of a tick, in the order update runs them
+    void updateBehaviour(float deltaTime);
+    void resolveCollisions();
+    void resolveGameplay();
+
+    bool checkForEdge(Enemy& enemy) const; // Turns an enemy around at the edge of the floor, returns whether it needed checking
+    bool m_parallelUpdate{ true };
+
+    void movePlatforms(); // Moves the platforms' tree entries and carries their riders, before the other bodies are resolved
+    bool isOnPlatform(const CollisionRectangle& area) const; // Whether the area overlaps a moving platform
+    void resolveBody(int body); // Resolves the collisions of a body's integrated move in the physics store, one axis at a time
+
+    TileLayer m_tileLayer; // Grid of tile IDs, used for all collisions against the level's tiles
+    SpatialHash m_broadphase; // Buckets the static non-tile entities (collectables and doors) by position
+    DynamicAabbTree m_bodyTree; // Holds everything that moves - the player, enemies, moving platforms and active bullets
+    std::vector<Entity*> m_candidates; // Reused each query to avoid reallocating
+    std::vector<CollisionRectangle> m_obstacles; // Hitboxes a dynamic entity can collide with, filled by gatherObstacles
+    std::vector<TileProperties> m_obstacleProperties; // How each obstacle collides - tiles have their own, moving bodies are plain solids
+    std::vector<int> m_colliderIds; // Reused each query of the merged colliders
+    PackedRectangles m_packedObstacles; // Candidate hitboxes packed for the batched overlap test
+    std::vector<int> m_obstacleHits; // Indices of the packed candidates that overlapped
+    int m_solidTileCount{ 0 }; // How many colliding tiles were merged into m_solidColliders
+
+    // Fills m_obstacles with the tile colliders and blocking entities overlapping the area, and m_obstacleProperties with how they collide, returns how many candidates were looked at
+    int gatherObstacles(const CollisionRectangle& area, const Entity* self);
+
+    // Keeping moving bodies in the dynamic AABB tree
+    void addBody(DynamicEntity* body);
+    void removeBody(DynamicEntity* body);
+    void updateBody(DynamicEntity* body, sf::Vector2f displacement);
+
+    void fireBullet(sf::Vector2f position, sf::Vector2f velocity, bool isEnemy); // Fires the first inactive bullet in the pool, if there is one
+
+    CollisionFilter m_collisionFilter; // Which collision layers test against which
+    void configureCollisionFilter();
+    void configureTileProperties(); // Sets how each tile in the tile sheet collides
+
+    static constexpr float SlopeStepHeight = 9.f; // How far below a slope's surface a body can start and still be lifted onto it, half a tile
+    static constexpr float SlopeSnapDistance = 4.f; // How far a grounded body walking down a slope can drop onto it, rather than falling
+    static constexpr float HazardCooldown = 1.f; // How long the player is safe from hazards after touching one, in seconds
+    TimerHandle m_hazardCooldown;
+    void assignCollisionLayer(Entity& entity, std::uint32_t layer) const { entity.setCollisionLayer(layer, m_collisionFilter.getMask(layer)); }
+
+    static constexpr int SleepAfterTicks = 30; // How long a body has to rest before it sleeps - half a second at the default tick rate
+    static constexpr float WakeDistance = 36.f; // How close the player has to be to wake a body, two tiles
+    int m_awakeBodyCount{ 0 };
+    int m_sleepingBodyCount{ 0 };
+    int m_frozenBodyCount{ 0 };
 
-    // For quicker access than looping through the vector
-    PlayerEntity* m_player{ nullptr };
+    bool m_broadphaseStatsEnabled{ false };
+    BroadphaseStats m_broadphaseStats;
 
 	void createEntityFromId(int id, float x, float y); // Creates an entity based on the ID from the level file
 	sf::Vector2f m_levelSize{ 500.f, 500.f }; // Defines the size of the level for camera bounds
@@ -0,0 +1,111 @@
+#include "SpatialHash.h"
+#include "Entity.h"
+#include <algorithm>
+#include <cmath>
+
+void SpatialHash::clear()
+{
+	for (Cells& cells : m_layerCells)
+		cells.clear();
+
+	m_placements.clear();
+}
+
+// Buckets the entity using its current hitbox and collision layer
+void SpatialHash::insert(Entity* entity)
+{
+	if (entity->getCollisionLayer() == CollisionLayers::None) return; // Can't collide with anything, so isn't stored
+
+	Placement placement;
+	placement.range = rangeFor(entity->getHitbox());
+	placement.layer = CollisionLayers::indexOf(entity->getCollisionLayer());
+
+	m_placements[entity] = placement;
+	addToCells(entity, placement);
+}
+
+void SpatialHash::remove(Entity* entity)
+{
+	auto it = m_placements.find(entity);
+	if (it == m_placements.end()) return; // Not in the grid
+
+	removeFromCells(entity, it->second);
+	m_placements.erase(it);
+}
+
+// Appends every entity on a layer in the mask in the cells overlapped by the area to the results, each entity is only added once
+void SpatialHash::query(const CollisionRectangle& area, std::uint32_t mask, std::vector<Entity*>& results) const
+{
+	std::size_t firstResult = results.size();
+	CellRange range = rangeFor(area);
+
+	// Only the buckets of layers in the mask are visited
+	for (std::uint32_t layers = mask & CollisionLayers::All; layers != 0; layers &= layers - 1)
+	{
+		const Cells& cells = m_layerCells[CollisionLayers::indexOf(layers)];
+		if (cells.empty()) continue;
+
+		for (int y = range.minY; y <= range.maxY; ++y)
+		{
+			for (int x = range.minX; x <= range.maxX; ++x)
+			{
+				auto cell = cells.find(key(x, y));
+				if (cell == cells.end()) continue; // Empty cell
+
+				results.insert(results.end(), cell->second.begin(), cell->second.end());
+			}
+		}
+	}
+
+	// Large entities can sit in more than one cell, so removes the duplicates
+	if (range.minX != range.maxX || range.minY != range.maxY)
+	{
+		std::sort(results.begin() + firstResult, results.end());
+		results.erase(std::unique(results.begin() + firstResult, results.end()), results.end());
+	}
+}
+
+// Converts a rectangle into the cells it covers - inclusive of touching edges, matching CollisionRectangle::intersection
+SpatialHash::CellRange SpatialHash::rangeFor(const CollisionRectangle& rect) const
+{
+	CellRange range;
+	range.minX = static_cast<int>(std::floor(rect.m_xPos / m_cellSize));
+	range.minY = static_cast<int>(std::floor(rect.m_yPos / m_cellSize));
+	range.maxX = static_cast<int>(std::floor((rect.m_xPos + rect.m_width) / m_cellSize));
+	range.maxY = static_cast<int>(std::floor((rect.m_yPos + rect.m_height) / m_cellSize));
+	return range;
+}
+
+void SpatialHash::addToCells(Entity* entity, const Placement& placement)
+{
+	Cells& cells = m_layerCells[placement.layer];
+	const CellRange& range = placement.range;
+
+	for (int y = range.minY; y <= range.maxY; ++y)
+		for (int x = range.minX; x <= range.maxX; ++x)
+			cells[key(x, y)].push_back(entity);
+}
+
+void SpatialHash::removeFromCells(Entity* entity, const Placement& placement)
+{
+	Cells& cells = m_layerCells[placement.layer];
+	const CellRange& range = placement.range;
+
+	for (int y = range.minY; y <= range.maxY; ++y)
+	{
+		for (int x = range.minX; x <= range.maxX; ++x)
+		{
+			auto cell = cells.find(key(x, y));
+			if (cell == cells.end()) continue;
+
+			// Swap and pop, the order within a cell doesn't matter
+			std::vector<Entity*>& bucket = cell->second;
+			auto found = std::find(bucket.begin(), bucket.end(), entity);
+			if (found != bucket.end())
+			{
+				*found = bucket.back();
+				bucket.pop_back();
+			}
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "CollisionRectangle.h"
+#include "CollisionLayers.h"
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+class Entity;
+
+// A uniform grid broadphase - entities are bucketed into every cell their hitbox overlaps, so collision checks only
+// need to test the entities in nearby cells rather than every entity in the level
+// Each collision layer has its own buckets, so a query never visits entities on layers its mask excludes
+// Only holds entities that never move once inserted (collectables and doors), anything that moves lives in the DynamicAabbTree
+class SpatialHash
+{
+public:
+	explicit SpatialHash(float cellSize = 36.f) : m_cellSize(cellSize) {}
+
+	void clear(); // Removes every entity from the grid
+
+	void insert(Entity* entity); // Buckets the entity using its current hitbox and collision layer
+	void remove(Entity* entity); // Removes the entity from every cell it occupies
+
+	// Appends every entity on a layer in the mask in the cells overlapped by the area to the results, each entity is only added once
+	void query(const CollisionRectangle& area, std::uint32_t mask, std::vector<Entity*>& results) const;
+
+	std::size_t size() const { return m_placements.size(); } // How many entities are in the grid
+private:
+	// The inclusive range of cells a hitbox covers
+	struct CellRange
+	{
+		int minX{ 0 };
+		int minY{ 0 };
+		int maxX{ 0 };
+		int maxY{ 0 };
+	};
+
+	// Where an entity is currently stored
+	struct Placement
+	{
+		CellRange range;
+		int layer{ 0 }; // Index of the layer's buckets
+	};
+
+	using Cells = std::unordered_map<long long, std::vector<Entity*>>;
+
+	CellRange rangeFor(const CollisionRectangle& rect) const; // Converts a rectangle into the cells it covers
+	static long long key(int x, int y) { return (static_cast<long long>(x) << 32) | static_cast<unsigned int>(y); }
+
+	void addToCells(Entity* entity, const Placement& placement);
+	void removeFromCells(Entity* entity, const Placement& placement);
+
+	float m_cellSize; // Width and height of a single cell
+
+	std::array<Cells, CollisionLayers::Count> m_layerCells; // Entities in each occupied cell, per layer
+	std::unordered_map<const Entity*, Placement> m_placements; // The cells and layer each entity currently occupies
+};
@@ -1,12 +1,49 @@
 #pragma once
+#include "JobSystem.h"
 #include <SFML/Graphics.hpp>
 #include <map>
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 class TextureManager
 {
 public:
+	TextureManager(JobSystem& jobSystem) : m_jobSystem(jobSystem) {}
+
+	// Loads every texture not already loaded - the files are decoded in parallel, then uploaded on this thread as that is the one with the OpenGL context
+	void preloadTextures(const std::vector<std::string>& filePaths)
+	{
+		std::vector<std::string> toLoad;
+		for (const std::string& filePath : filePaths)
+		{
+			if (m_textures.find(filePath) == m_textures.end() && std::find(toLoad.begin(), toLoad.end(), filePath) == toLoad.end())
+				toLoad.push_back(filePath);
+		}
+
+		std::vector<sf::Image> images(toLoad.size());
+		std::vector<char> decoded(toLoad.size(), 0); // Not vector<bool>, as each job writes its own element
+
+		m_jobSystem.parallelFor(static_cast<int>(toLoad.size()), 1, [&](int begin, int end)
+			{
+				for (int i = begin; i < end; ++i)
+					decoded[i] = images[i].loadFromFile(toLoad[i]) ? 1 : 0;
+			});
+
+		for (std::size_t i = 0; i < toLoad.size(); ++i)
+		{
+			sf::Texture texture;
+			if (!decoded[i] || !texture.loadFromImage(images[i]))
+			{
+				std::cout << "Texture " << toLoad[i] << " could not be loaded!" << std::endl;
+				continue;
+			}
+
+			m_textures[toLoad[i]] = texture;
+		}
+	}
+
 	// Creates a method that checks whether the texture has already been loaded, if so it doesn't load it again. If not it attemps to load it.
 	sf::Texture* getTexture(const std::string& filePath)
 	{
@@ -26,5 +63,7 @@ public:
 		return &m_textures.at(filePath); // Returns the texture, either if already loaded, or just loaded
 	}
 private:
+	JobSystem& m_jobSystem; // Decodes the image files when preloading
+
 	std::unordered_map<std::string, sf::Texture> m_textures;
 };
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "TileLayer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Clears the grid and sets its dimensions
+void TileLayer::resize(int columns, int rows, float tileSize)
+{
+	m_columns = columns;
+	m_rows = rows;
+	m_tileSize = tileSize;
+
+	m_tiles.assign(static_cast<std::size_t>(columns) * rows, 0);
+	m_colliderIds.assign(static_cast<std::size_t>(columns) * rows, -1);
+	m_spanIds.assign(static_cast<std::size_t>(columns) * rows, -1);
+	m_walkableSpans.clear();
+}
+
+void TileLayer::setTile(int column, int row, int id)
+{
+	if (column < 0 || row < 0 || column >= m_columns || row >= m_rows) return; // Outside the grid
+
+	m_tiles[row * m_columns + column] = id;
+}
+
+// Returns 0 (empty) for cells outside the grid
+int TileLayer::getTile(int column, int row) const
+{
+	if (column < 0 || row < 0 || column >= m_columns || row >= m_rows) return 0;
+
+	return m_tiles[row * m_columns + column];
+}
+
+// Greedily merges adjacent tiles with the same properties into maximal rectangles, appending them to the colliders. Returns how many tiles were merged
+int TileLayer::bakeColliders(std::vector<CollisionRectangle>& colliders)
+{
+	std::fill(m_colliderIds.begin(), m_colliderIds.end(), -1);
+	m_colliderProperties.assign(colliders.size(), TileProperties{}); // Keeps the indices in step with any colliders already in the list
+	int mergedTiles = 0;
+
+	// A cell can join a collider if it has the collider's properties and isn't already part of one
+	auto isFree = [&](int column, int row, const TileProperties& properties)
+		{
+			return m_colliderIds[row * m_columns + column] == -1 && m_properties.get(m_tiles[row * m_columns + column]) == properties;
+		};
+
+	for (int row = 0; row < m_rows; ++row)
+	{
+		for (int column = 0; column < m_columns; ++column)
+		{
+			const TileProperties& properties = getProperties(column, row);
+			if (properties.flags == TileFlags::None || m_colliderIds[row * m_columns + column] != -1) continue;
+
+			bool isSlope = (properties.flags & TileFlags::Slope) != 0;
+			bool isOneWay = (properties.flags & TileFlags::OneWay) != 0;
+
+			// Extends right as far as the run of matching tiles goes - a slope's surface is only defined over its own tile
+			int width = 1;
+			while (!isSlope && column + width < m_columns && isFree(column + width, row, properties))
+				width++;
+
+			// Extends down while the whole run below also matches - a one-way collider only has one top to land on
+			int height = 1;
+			while (!isSlope && !isOneWay && row + height < m_rows)
+			{
+				bool fullRun = true;
+				for (int x = column; x < column + width; ++x)
+				{
+					if (!isFree(x, row + height, properties))
+					{
+						fullRun = false;
+						break;
+					}
+				}
+
+				if (!fullRun) break;
+				height++;
+			}
+
+			// Marks the cells as belonging to the new collider
+			int colliderId = static_cast<int>(colliders.size());
+			for (int y = row; y < row + height; ++y)
+				for (int x = column; x < column + width; ++x)
+					m_colliderIds[y * m_columns + x] = colliderId;
+
+			mergedTiles += width * height;
+			colliders.emplace_back(column * m_tileSize, row * m_tileSize, height * m_tileSize, width * m_tileSize);
+			m_colliderProperties.push_back(properties);
+		}
+	}
+
+	return mergedTiles;
+}
+
+// Appends the index of every baked collider overlapping the area (each only once), returns how many cells were looked at
+int TileLayer::queryColliders(const CollisionRectangle& area, std::vector<int>& colliderIds) const
+{
+	int minColumn, minRow, maxColumn, maxRow;
+	if (!cellRange(area, minColumn, minRow, maxColumn, maxRow)) return 0;
+
+	std::size_t firstResult = colliderIds.size();
+
+	for (int row = minRow; row <= maxRow; ++row)
+	{
+		for (int column = minColumn; column <= maxColumn; ++column)
+		{
+			int colliderId = m_colliderIds[row * m_columns + column];
+			if (colliderId == -1) continue;
+
+			// Merged colliders span several cells, so skips ones already found - the list is only ever a handful long
+			if (std::find(colliderIds.begin() + firstResult, colliderIds.end(), colliderId) == colliderIds.end())
+				colliderIds.push_back(colliderId);
+		}
+	}
+
+	return (maxColumn - minColumn + 1) * (maxRow - minRow + 1);
+}
+
+// Whether any tile that can be stood on overlaps the area
+bool TileLayer::overlapsFloor(const CollisionRectangle& area) const
+{
+	int minColumn, minRow, maxColumn, maxRow;
+	if (!cellRange(area, minColumn, minRow, maxColumn, maxRow)) return false;
+
+	for (int row = minRow; row <= maxRow; ++row)
+	{
+		for (int column = minColumn; column <= maxColumn; ++column)
+		{
+			if (isFloor(column, row))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+// Converts the area into the inclusive range of cells it covers, clamped to the grid - touching edges count, matching CollisionRectangle::intersection
+bool TileLayer::cellRange(const CollisionRectangle& area, int& minColumn, int& minRow, int& maxColumn, int& maxRow) const
+{
+	// A tile whose far edge lies exactly on the area's near edge is touching it, hence ceil - 1 rather than floor
+	minColumn = static_cast<int>(std::ceil(area.m_xPos / m_tileSize)) - 1;
+	minRow = static_cast<int>(std::ceil(area.m_yPos / m_tileSize)) - 1;
+	maxColumn = static_cast<int>(std::floor((area.m_xPos + area.m_width) / m_tileSize));
+	maxRow = static_cast<int>(std::floor((area.m_yPos + area.m_height) / m_tileSize));
+
+	// Clamps to the grid
+	if (minColumn < 0) minColumn = 0;
+	if (minRow < 0) minRow = 0;
+	if (maxColumn >= m_columns) maxColumn = m_columns - 1;
+	if (maxRow >= m_rows) maxRow = m_rows - 1;
+
+	return minColumn <= maxColumn && minRow <= maxRow;
+}
+
+// Finds every walkable span in every row, so edge checks become a single lookup. Returns how many spans were found
+int TileLayer::buildWalkableSpans()
+{
+	m_walkableSpans.clear();
+	std::fill(m_spanIds.begin(), m_spanIds.end(), -1);
+
+	// A cell can be stood in if it is open with floor under it - one-way tiles and slopes are floors, but only solid tiles are walls
+	auto isWalkable = [&](int column, int row) { return !isSolid(column, row) && isFloor(column, row + 1); };
+
+	for (int row = 0; row < m_rows; ++row)
+	{
+		int column = 0;
+		while (column < m_columns)
+		{
+			if (!isWalkable(column, row))
+			{
+				column++;
+				continue;
+			}
+
+			// Extends right for as long as there is floor, every cell in the run points at the same span
+			int spanId = static_cast<int>(m_walkableSpans.size());
+			int first = column;
+			while (column < m_columns && isWalkable(column, row))
+				m_spanIds[row * m_columns + column++] = spanId;
+
+			WalkableSpan span;
+			span.left = first * m_tileSize;
+			span.right = column * m_tileSize;
+			span.blockedLeft = isSolid(first - 1, row);
+			span.blockedRight = isSolid(column, row);
+			m_walkableSpans.push_back(span);
+		}
+	}
+
+	return static_cast<int>(m_walkableSpans.size());
+}
+
+// The span under a body standing with its feet at the given height, or null if there is no floor under that point
+const WalkableSpan* TileLayer::getWalkableSpan(float x, float feetY) const
+{
+	// Looks at the cell half a tile above the feet, so feet resting exactly on a tile's top edge still find the row above it
+	int column = static_cast<int>(std::floor(x / m_tileSize));
+	int row = static_cast<int>(std::floor((feetY - m_tileSize / 2.f) / m_tileSize));
+
+	if (column < 0 || row < 0 || column >= m_columns || row >= m_rows) return nullptr;
+
+	int spanId = m_spanIds[row * m_columns + column];
+	return (spanId == -1) ? nullptr : &m_walkableSpans[spanId];
+}
+
+// Walks the cells along the ray in order (Amanatides-Woo DDA), stopping at the first solid tile. Returns whether one was hit
+bool TileLayer::raycast(float startX, float startY, float endX, float endY, TileRaycastHit& hit) const
+{
+	const float infinity = std::numeric_limits<float>::infinity();
+
+	float directionX = endX - startX;
+	float directionY = endY - startY;
+
+	int column = static_cast<int>(std::floor(startX / m_tileSize));
+	int row = static_cast<int>(std::floor(startY / m_tileSize));
+	int endColumn = static_cast<int>(std::floor(endX / m_tileSize));
+	int endRow = static_cast<int>(std::floor(endY / m_tileSize));
+
+	// Starting inside a solid tile counts as hitting it straight away
+	if (isSolid(column, row))
+	{
+		hit.column = column;
+		hit.row = row;
+		hit.fraction = 0.f;
+		return true;
+	}
+
+	int stepX = (directionX > 0.f) ? 1 : (directionX < 0.f) ? -1 : 0;
+	int stepY = (directionY > 0.f) ? 1 : (directionY < 0.f) ? -1 : 0;
+
+	// How far along the ray the next vertical and horizontal cell boundaries are, and how far apart they are
+	float nextX = (stepX > 0) ? ((column + 1) * m_tileSize - startX) / directionX : (stepX < 0) ? (column * m_tileSize - startX) / directionX : infinity;
+	float nextY = (stepY > 0) ? ((row + 1) * m_tileSize - startY) / directionY : (stepY < 0) ? (row * m_tileSize - startY) / directionY : infinity;
+	float deltaX = (stepX != 0) ? m_tileSize / std::abs(directionX) : infinity;
+	float deltaY = (stepY != 0) ? m_tileSize / std::abs(directionY) : infinity;
+
+	// Every step moves one cell closer to the end cell on one axis, so this many steps always reach it
+	int steps = std::abs(endColumn - column) + std::abs(endRow - row);
+
+	for (int i = 0; i < steps; ++i)
+	{
+		float fraction;
+
+		// Crosses whichever boundary comes first, on a tie the vertical step is taken so the ray can't slip between two diagonal tiles
+		if (nextX < nextY)
+		{
+			column += stepX;
+			fraction = nextX;
+			nextX += deltaX;
+		}
+		else
+		{
+			row += stepY;
+			fraction = nextY;
+			nextY += deltaY;
+		}
+
+		if (isSolid(column, row))
+		{
+			hit.column = column;
+			hit.row = row;
+			hit.fraction = std::min(fraction, 1.f);
+			return true;
+		}
+	}
+
+	return false; // Reached the end without hitting anything
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "CollisionRectangle.h"
+#include "TileProperties.h"
+#include <vector>
+
+// A run of open cells along a tile row with solid floor under every one of them - somewhere that can be walked along without falling
+struct WalkableSpan
+{
+	float left{ 0.f }; // World space x-extent of the floor
+	float right{ 0.f };
+
+	// Whether an end runs into a wall rather than dropping off, walls are left to the collision resolver
+	bool blockedLeft{ false };
+	bool blockedRight{ false };
+};
+
+// The first solid tile along a ray
+struct TileRaycastHit
+{
+	int column{ 0 };
+	int row{ 0 };
+	float fraction{ 0.f }; // How far along the ray (0 - 1) it entered the tile
+};
+
+// A dense grid of tile IDs for the level - one cell per tile, 0 being empty space
+// Lets physics find the tiles overlapping an area using index arithmetic alone, rather than testing every tile entity
+class TileLayer
+{
+public:
+	void resize(int columns, int rows, float tileSize); // Clears the grid and sets its dimensions
+
+	void setTile(int column, int row, int id);
+	int getTile(int column, int row) const; // Returns 0 (empty) for cells outside the grid
+
+	// How each tile ID collides, looked up by ID - set once, before any level is loaded
+	void setProperties(const TilePropertyTable& properties) { m_properties = properties; }
+	const TileProperties& getProperties(int column, int row) const { return m_properties.get(getTile(column, row)); }
+
+	bool isSolid(int column, int row) const { return (getProperties(column, row).flags & TileFlags::Solid) != 0; } // Blocks movement from every side
+	bool isFloor(int column, int row) const { return (getProperties(column, row).flags & (TileFlags::Solid | TileFlags::OneWay | TileFlags::Slope)) != 0; } // Can be stood on
+
+	int getColumns() const { return m_columns; }
+	int getRows() const { return m_rows; }
+	float getTileSize() const { return m_tileSize; }
+
+	// Greedily merges adjacent tiles with the same properties into maximal rectangles, appending them to the colliders. Returns how many tiles were merged
+	// One-way tiles are only merged along their row, and slopes not at all, so each keeps its own surface. Tiles that collide with nothing get no collider
+	int bakeColliders(std::vector<CollisionRectangle>& colliders);
+	const TileProperties& getColliderProperties(int colliderId) const { return m_colliderProperties[colliderId]; } // Shared by every tile in the collider
+
+	// Appends the index of every baked collider overlapping the area (each only once), returns how many cells were looked at
+	int queryColliders(const CollisionRectangle& area, std::vector<int>& colliderIds) const;
+	bool overlapsFloor(const CollisionRectangle& area) const; // Whether any tile that can be stood on overlaps the area
+
+	// Finds every walkable span in every row, so edge checks become a single lookup. Called once the tiles are placed
+	int buildWalkableSpans(); // Returns how many spans were found
+
+	// The span under a body standing with its feet at the given height, or null if there is no floor under that point
+	const WalkableSpan* getWalkableSpan(float x, float feetY) const;
+
+	// Walks the cells along the ray in order (Amanatides-Woo DDA), stopping at the first solid tile. Returns whether one was hit
+	// One-way tiles and slopes don't stop it. Only the cells the ray passes through are looked at, so the cost is proportional to its length in cells
+	bool raycast(float startX, float startY, float endX, float endY, TileRaycastHit& hit) const;
+private:
+	// Converts the area into the inclusive range of cells it covers, clamped to the grid. Returns false if it is entirely outside
+	bool cellRange(const CollisionRectangle& area, int& minColumn, int& minRow, int& maxColumn, int& maxRow) const;
+
+	int m_columns{ 0 };
+	int m_rows{ 0 };
+	float m_tileSize{ 18.f };
+
+	std::vector<int> m_tiles; // Row-major tile IDs
+	std::vector<int> m_colliderIds; // Row-major index of the baked collider covering each cell, -1 if none
+	std::vector<TileProperties> m_colliderProperties; // The properties of each baked collider, by its index
+
+	TilePropertyTable m_properties;
+
+	std::vector<WalkableSpan> m_walkableSpans;
+	std::vector<int> m_spanIds; // Row-major index of the walkable span each cell belongs to, -1 if none
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// How a tile collides, stored per tile ID rather than per placed tile
+namespace TileFlags
+{
+	constexpr std::uint8_t None = 0; // Decoration, nothing collides with it
+	constexpr std::uint8_t Solid = 1 << 0; // Blocks movement from every side
+	constexpr std::uint8_t OneWay = 1 << 1; // Can only be landed on from above - jumped up through and walked under
+	constexpr std::uint8_t Slope = 1 << 2; // A floor whose height changes across the tile, walked up and down rather than blocked by
+	constexpr std::uint8_t Hazard = 1 << 3; // Hurts the player on contact
+}
+
+struct TileProperties
+{
+	std::uint8_t flags{ TileFlags::Solid };
+
+	// For slopes, the height of the surface at the tile's left and right edges, as a fraction of the tile (0 the bottom, 1 the top)
+	float slopeLeft{ 1.f };
+	float slopeRight{ 1.f };
+
+	bool operator==(const TileProperties&) const = default;
+
+	// Where the surface is across the tile (0 - 1 from its left edge), as a fraction of the tile's height from the bottom
+	float surfaceHeight(float across) const { return slopeLeft + (slopeRight - slopeLeft) * across; }
+};
+
+// The properties of every tile ID, looked up by indexing - ID 0 is empty space, and IDs outside the table are plain solids
+// Configured once by the simulation for the tile sheet, like the collision filter
+class TilePropertyTable
+{
+public:
+	static constexpr int MaxTileId = 199; // Level IDs from 200 are special entities, not tiles
+
+	TilePropertyTable() { m_properties[0].flags = TileFlags::None; }
+
+	void set(int id, std::uint8_t flags) { if (id >= 0 && id <= MaxTileId) m_properties[id].flags = flags; }
+	void setSlope(int id, float left, float right)
+	{
+		if (id < 0 || id > MaxTileId) return;
+		m_properties[id] = { TileFlags::Slope, left, right };
+	}
+
+	const TileProperties& get(int id) const { return (id >= 0 && id <= MaxTileId) ? m_properties[id] : PlainSolid; }
+private:
+	static constexpr TileProperties PlainSolid{};
+
+	std::array<TileProperties, MaxTileId + 1> m_properties{}; // Every ID starts as a plain solid
+};
@@ -0,0 +1,187 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#include <cmath>
+
+TimerWheel::TimerWheel()
+{
+	m_slots.fill(-1);
+}
+
+TimerHandle TimerWheel::schedule(std::uint32_t ticks, std::function<void()> callback)
+{
+	int index;
+	if (!m_freeTimers.empty())
+	{
+		index = m_freeTimers.back();
+		m_freeTimers.pop_back();
+	}
+	else
+	{
+		index = static_cast<int>(m_timers.size());
+		m_timers.emplace_back();
+	}
+
+	Timer& timer = m_timers[index];
+	timer.callback = std::move(callback);
+	timer.expiry = m_tick + std::max<std::uint32_t>(ticks, 1);
+	timer.inUse = true;
+	m_pendingCount++;
+
+	insert(index);
+
+	return { index, timer.generation };
+}
+
+void TimerWheel::cancel(TimerHandle& handle)
+{
+	if (isPending(handle))
+	{
+		unlink(handle.index);
+		release(handle.index);
+	}
+
+	handle = TimerHandle{};
+}
+
+bool TimerWheel::isPending(const TimerHandle& handle) const
+{
+	if (handle.index < 0 || handle.index >= static_cast<int>(m_timers.size())) return false;
+
+	const Timer& timer = m_timers[handle.index];
+	return timer.inUse && timer.generation == handle.generation;
+}
+
+void TimerWheel::advance(float deltaTime)
+{
+	m_tickLength = deltaTime;
+	m_tick++;
+	m_firedCount = 0;
+
+	// Each time a finer wheel wraps back to its first slot, the coarser wheel's next slot is due to be moved down
+	for (int wheel = 1; wheel < WheelCount; ++wheel)
+	{
+		if (((m_tick >> ((wheel - 1) * SlotBits)) & (SlotCount - 1)) != 0) break;
+		cascade(wheel);
+	}
+
+	// Every timer in the first wheel's slot for this tick is due - they are all collected first, as the callbacks may schedule or cancel timers
+	int& head = m_slots[m_tick & (SlotCount - 1)];
+
+	m_due.clear();
+	for (int index = head; index != -1; index = m_timers[index].next)
+	{
+		m_timers[index].slot = Unlinked;
+		m_due.push_back({ index, m_timers[index].generation });
+	}
+	head = -1;
+
+	for (const TimerHandle& due : m_due)
+	{
+		if (!isPending(due)) continue; // Cancelled by an earlier callback
+
+		// Freed before the callback runs, so the callback sees it as fired and can reschedule
+		std::function<void()> callback = std::move(m_timers[due.index].callback);
+		release(due.index);
+		m_firedCount++;
+
+		if (callback)
+			callback();
+	}
+}
+
+std::uint32_t TimerWheel::ticksFor(float seconds) const
+{
+	return static_cast<std::uint32_t>(std::max(1.f, std::round(seconds / m_tickLength)));
+}
+
+void TimerWheel::clear()
+{
+	for (int index = 0; index < static_cast<int>(m_timers.size()); ++index)
+	{
+		if (!m_timers[index].inUse) continue;
+
+		m_timers[index].slot = Unlinked; // The slots are all emptied below
+		release(index);
+	}
+
+	m_slots.fill(-1);
+	m_due.clear();
+}
+
+void TimerWheel::reserve(int timerCount)
+{
+	m_timers.reserve(timerCount);
+	m_freeTimers.reserve(timerCount);
+	m_due.reserve(timerCount);
+}
+
+// Picks the finest wheel that can hold the timer, and the slot in it for the timer's expiry
+void TimerWheel::insert(int index)
+{
+	Timer& timer = m_timers[index];
+	std::uint64_t delta = timer.expiry - m_tick;
+	std::uint64_t expiry = timer.expiry;
+
+	int wheel = 0;
+	while (wheel < WheelCount - 1 && delta >= (std::uint64_t(1) << ((wheel + 1) * SlotBits)))
+		wheel++;
+
+	// Beyond the last wheel's range, waits in its furthest slot and is placed again when that slot is moved down
+	std::uint64_t range = std::uint64_t(1) << (WheelCount * SlotBits);
+	if (delta >= range)
+		expiry = m_tick + range - 1;
+
+	int slot = wheel * SlotCount + static_cast<int>((expiry >> (wheel * SlotBits)) & (SlotCount - 1));
+
+	timer.slot = slot;
+	timer.previous = -1;
+	timer.next = m_slots[slot];
+	if (timer.next != -1)
+		m_timers[timer.next].previous = index;
+	m_slots[slot] = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+	Timer& timer = m_timers[index];
+	if (timer.slot == Unlinked) return;
+
+	if (timer.previous != -1)
+		m_timers[timer.previous].next = timer.next;
+	else
+		m_slots[timer.slot] = timer.next;
+
+	if (timer.next != -1)
+		m_timers[timer.next].previous = timer.previous;
+
+	timer.slot = Unlinked;
+}
+
+void TimerWheel::release(int index)
+{
+	Timer& timer = m_timers[index];
+	timer.callback = nullptr;
+	timer.inUse = false;
+	timer.generation++;
+	m_freeTimers.push_back(index);
+	m_pendingCount--;
+}
+
+// Moves every timer in the coarser wheel's current slot into the finer wheels, now that they are close enough to be placed exactly
+int TimerWheel::cascade(int wheel)
+{
+	int slotIndex = static_cast<int>((m_tick >> (wheel * SlotBits)) & (SlotCount - 1));
+	int& head = m_slots[wheel * SlotCount + slotIndex];
+
+	int index = head;
+	head = -1;
+
+	while (index != -1)
+	{
+		int next = m_timers[index].next;
+		insert(index);
+		index = next;
+	}
+
+	return slotIndex;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Refers to a scheduled timer - stays safe to use after the timer fires or is cancelled, it just stops being pending
+struct TimerHandle
+{
+	int index{ -1 };
+	std::uint32_t generation{ 0 };
+};
+
+// Hierarchical timer wheel keyed by simulation tick
+// Timers due within 64 ticks sit in the first wheel's slot for their tick, later ones in coarser wheels, and are moved down as their tick approaches
+// Advancing a tick only touches the timers due that tick (and occasionally a coarser slot being moved down), however many are waiting
+// Cooldowns can be timers with no callback - being pending is the flag
+class TimerWheel
+{
+public:
+	TimerWheel();
+
+	// Schedules a timer for the given number of ticks from now (at least one), the callback may be empty
+	TimerHandle schedule(std::uint32_t ticks, std::function<void()> callback = nullptr);
+	void cancel(TimerHandle& handle); // Stops the timer if it is pending, and resets the handle
+	bool isPending(const TimerHandle& handle) const;
+
+	// Moves on a tick, firing every timer due on it - deltaTime is the tick's length, used to convert seconds
+	void advance(float deltaTime);
+
+	// Converts a duration into whole ticks at the current tick rate, at least one
+	std::uint32_t ticksFor(float seconds) const;
+
+	void clear(); // Drops every timer without firing it
+	void reserve(int timerCount); // Makes room for that many pending timers, so scheduling doesn't allocate
+
+	std::uint64_t getTick() const { return m_tick; }
+	int getPendingCount() const { return m_pendingCount; }
+	int getFiredCount() const { return m_firedCount; } // How many fired on the last advance
+private:
+	static constexpr int SlotBits = 6;
+	static constexpr int SlotCount = 1 << SlotBits; // Slots per wheel
+	static constexpr int WheelCount = 4; // Covers 2^24 ticks, over three days at 60Hz - anything later waits in the last slot
+
+	static constexpr int Unlinked = -1; // Not in any slot - free, or about to fire
+
+	// A timer, linked into the list of the slot it is waiting in
+	struct Timer
+	{
+		std::function<void()> callback;
+		std::uint64_t expiry{ 0 };
+		std::uint32_t generation{ 0 }; // Bumped whenever the timer is freed, so old handles stop matching
+		bool inUse{ false };
+		int slot{ Unlinked };
+		int previous{ -1 };
+		int next{ -1 };
+	};
+
+	void insert(int index); // Links the timer into the slot for its expiry
+	void unlink(int index);
+	void release(int index); // Frees the timer for reuse
+	int cascade(int wheel); // Moves the current slot of a coarser wheel down into the finer ones, returns the slot's index
+
+	std::vector<Timer> m_timers; // Pooled, so scheduling doesn't allocate once the pool has grown
+	std::vector<int> m_freeTimers;
+	std::array<int, SlotCount * WheelCount> m_slots; // Head of each slot's list
+
+	std::vector<TimerHandle> m_due; // Timers firing this tick, reused each advance
+
+	std::uint64_t m_tick{ 0 };
+	float m_tickLength{ 1.f / 60.f };
+	int m_pendingCount{ 0 };
+	int m_firedCount{ 0 };
+};
@@ -0,0 +1,113 @@
+#include "TriggerVolumes.h"
+#include "Entity.h"
+#include <algorithm>
+#include <cmath>
+
+void TriggerVolumes::clear()
+{
+	m_triggers.clear();
+	m_cells.clear();
+	m_overlaps.clear();
+}
+
+int TriggerVolumes::add(const std::string& name, const CollisionRectangle& area)
+{
+	int index = static_cast<int>(m_triggers.size());
+	m_triggers.push_back({ name, area });
+
+	// Triggers never move, so are bucketed once into every cell they cover
+	int minX = static_cast<int>(std::floor(area.m_xPos / m_cellSize));
+	int minY = static_cast<int>(std::floor(area.m_yPos / m_cellSize));
+	int maxX = static_cast<int>(std::floor((area.m_xPos + area.m_width) / m_cellSize));
+	int maxY = static_cast<int>(std::floor((area.m_yPos + area.m_height) / m_cellSize));
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+			m_cells[key(x, y)].push_back(index);
+	}
+
+	return index;
+}
+
+void TriggerVolumes::update(std::span<Entity* const> entities, std::pmr::vector<TriggerEvent>& events)
+{
+	m_currentOverlaps.clear();
+
+	for (Entity* entity : entities)
+	{
+		const CollisionRectangle& hitbox = entity->getHitbox();
+
+		int minX = static_cast<int>(std::floor(hitbox.m_xPos / m_cellSize));
+		int minY = static_cast<int>(std::floor(hitbox.m_yPos / m_cellSize));
+		int maxX = static_cast<int>(std::floor((hitbox.m_xPos + hitbox.m_width) / m_cellSize));
+		int maxY = static_cast<int>(std::floor((hitbox.m_yPos + hitbox.m_height) / m_cellSize));
+
+		// Only the triggers sharing a cell with the entity are tested, empty cells aren't in the map at all
+		m_candidates.clear();
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int x = minX; x <= maxX; ++x)
+			{
+				auto cell = m_cells.find(key(x, y));
+				if (cell != m_cells.end())
+					m_candidates.insert(m_candidates.end(), cell->second.begin(), cell->second.end());
+			}
+		}
+
+		// A trigger spanning several of the entity's cells is only tested once
+		std::sort(m_candidates.begin(), m_candidates.end());
+		m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()), m_candidates.end());
+
+		for (int trigger : m_candidates)
+		{
+			if (hitbox.intersection(m_triggers[trigger].area))
+				m_currentOverlaps.emplace_back(trigger, entity);
+		}
+	}
+
+	std::sort(m_currentOverlaps.begin(), m_currentOverlaps.end());
+
+	for (Trigger& trigger : m_triggers)
+		trigger.occupants = 0;
+
+	// Both lists are sorted, so one merge finds which overlaps are new, continuing or gone
+	std::size_t previous = 0;
+	std::size_t current = 0;
+	while (previous < m_overlaps.size() || current < m_currentOverlaps.size())
+	{
+		if (current == m_currentOverlaps.size() || (previous < m_overlaps.size() && m_overlaps[previous] < m_currentOverlaps[current]))
+		{
+			events.push_back({ m_overlaps[previous].first, m_overlaps[previous].second, TriggerTransition::Exit });
+			previous++;
+			continue;
+		}
+
+		const Overlap& overlap = m_currentOverlaps[current];
+		bool stayed = previous < m_overlaps.size() && m_overlaps[previous] == overlap;
+
+		events.push_back({ overlap.first, overlap.second, stayed ? TriggerTransition::Stay : TriggerTransition::Enter });
+		m_triggers[overlap.first].occupants++;
+
+		if (stayed) previous++;
+		current++;
+	}
+
+	m_overlaps.swap(m_currentOverlaps);
+}
+
+void TriggerVolumes::remove(const Entity* entity)
+{
+	m_overlaps.erase(std::remove_if(m_overlaps.begin(), m_overlaps.end(), [entity](const Overlap& overlap) { return overlap.second == entity; }), m_overlaps.end());
+}
+
+const Trigger* TriggerVolumes::find(const std::string& name) const
+{
+	for (const Trigger& trigger : m_triggers)
+	{
+		if (trigger.name == name)
+			return &trigger;
+	}
+
+	return nullptr;
+}
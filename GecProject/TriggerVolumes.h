@@ -0,0 +1,67 @@
+#pragma once
+#include "CollisionRectangle.h"
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Entity;
+
+// A named area of the level that reports what enters, stays in and leaves it, without blocking anything
+struct Trigger
+{
+	std::string name;
+	CollisionRectangle area;
+	int occupants{ 0 }; // How many entities were inside after the last update
+};
+
+enum class TriggerTransition
+{
+	Enter, // Overlapping this tick, but not last tick
+	Stay, // Overlapping both ticks
+	Exit, // Overlapped last tick, but not this one
+
+	Count
+};
+
+struct TriggerEvent
+{
+	int trigger{ -1 }; // Index into TriggerVolumes::getTriggers
+	Entity* entity{ nullptr };
+	TriggerTransition transition{ TriggerTransition::Enter };
+};
+
+// Trigger volumes bucketed into a uniform grid, so each update only tests the triggers in the cells the given entities cover
+// Any number of triggers cost nothing while nobody is near them
+class TriggerVolumes
+{
+public:
+	explicit TriggerVolumes(float cellSize = 72.f) : m_cellSize(cellSize) {}
+
+	void clear();
+	int add(const std::string& name, const CollisionRectangle& area); // Returns the trigger's index
+
+	// Tests the entities against the triggers in their cells, appending this tick's transitions to events
+	void update(std::span<Entity* const> entities, std::pmr::vector<TriggerEvent>& events);
+
+	// Forgets the entity without an exit event, for when it is destroyed
+	void remove(const Entity* entity);
+
+	const std::vector<Trigger>& getTriggers() const { return m_triggers; }
+	const Trigger* find(const std::string& name) const;
+private:
+	using Overlap = std::pair<int, Entity*>; // A trigger and an entity inside it
+
+	static long long key(int x, int y) { return (static_cast<long long>(x) << 32) | static_cast<unsigned int>(y); }
+
+	float m_cellSize;
+
+	std::vector<Trigger> m_triggers;
+	std::unordered_map<long long, std::vector<int>> m_cells; // The triggers overlapping each occupied cell
+
+	std::vector<Overlap> m_overlaps; // Last update's overlaps, sorted
+	std::vector<Overlap> m_currentOverlaps; // This update's, reused to avoid reallocating
+	std::vector<int> m_candidates; // Triggers in an entity's cells, reused each update
+};
@@ -5,10 +5,16 @@
 
 #include "RedirectCout.h"
 #include "Graphics.h"
+#include "AllocationTest.h"
+#include <cstring>
 
 
-int main()
+int main(int argc, char* argv[])
 {
+    // Headless check that the simulation doesn't allocate once warmed up, printed to the real console rather than redirected
+    if (argc > 1 && std::strcmp(argv[1], "--alloc-test") == 0)
+        return AllocationTest::run();
+
     // Redirect cout to the Visual Studio output pane
     outbuf ob;
     std::streambuf* sb{ std::cout.rdbuf(&ob) };